@@ -20,9 +20,31 @@ public:
 	static Engine& engine()
 	{ return Engine::ref(); }
 
+	// Read before the application is constructed, hide it in the subclass to change the logging setup
+	static LogSettings log_settings()
+	{ return {}; }
+
+	// Read before the window is created, hide it in the subclass to pick the display mode and frame pacing
+	static DisplaySettings display_settings()
+	{ return {}; }
+
 	virtual Duration fixed_time_step() const
 	{ return duration_cast<Duration>(std::chrono::duration<Duration::rep, std::ratio<1, 30>>{1}); }
 
+	// Watches the files assets were loaded from and reloads them in place when they change
+	virtual bool hot_reload() const
+	{ return false; }
+
+	// Only draws a frame after Engine::request_redraw(), the loop sleeps until events arrive or the next update is
+	// due. Input does not redraw by itself, handlers request it when something changed. A long fixed_time_step()
+	// keeps the engine asleep in between.
+	virtual bool on_demand() const
+	{ return false; }
+
+	// Dispatches the mouse motion queued during update again right before frame_start, see Input
+	virtual bool resample_input() const
+	{ return true; }
+
 	virtual void initialize() = 0;
 
 	virtual void update(Duration) = 0;
@@ -30,9 +52,14 @@ public:
 	virtual void frame_start()
 	{ }
 
+	// Renders into the scaled target when dynamic resolution is on. Painter only reaches GL in end_frame(), scene
+	// painting needs its own begin_frame(size, Engine::render_scale()) / end_frame() pair in here, a painter frame
+	// ended in frame_end() is flushed after the upscale and lands on the backbuffer instead. The script frame()
+	// callback runs right after, a painter frame begun at the end of frame() collects it for the native pass.
 	virtual void frame()
 	{ }
 
+	// Runs at native resolution once the scene is upscaled when dynamic resolution is on, for text and UI
 	virtual void frame_end()
 	{ }
 
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <engine/utils/FileSystem.hpp>
+#include <engine/config.h>
+
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <map>
+
+/*
+ * File reads and writes on a small pool of worker threads.
+ *
+ * Requests are served by priority, then in the order they were made. Completions never run on the workers,
+ * they are queued and run by dispatch(), which the engine calls from the main loop right before update.
+ */
+class ENGINE_API AsyncIO final
+{
+public:
+	typedef glm::uint Request;
+
+	static const Request Invalid = 0;
+
+	enum class Priority
+	{
+		Low,
+		Normal,
+		High
+	};
+
+	enum class Status
+	{
+		Done,
+		Failed,
+		Cancelled
+	};
+
+	struct Result
+	{
+		Request request;
+		Status status;
+		filesystem::Path path;
+		std::vector<unsigned char> data; // Empty for reads into a caller buffer and for writes
+		size_t size; // Bytes actually read or written
+		std::string error;
+	};
+
+	typedef std::function<void(Result&)> Completion;
+
+	explicit AsyncIO(unsigned workers = 2);
+
+	~AsyncIO();
+
+	AsyncIO(AsyncIO const& other) = delete;
+
+	AsyncIO& operator=(AsyncIO const& other) = delete;
+
+	// Reads the whole file
+	Request read(filesystem::Path const& file, Completion done, Priority priority = Priority::Normal);
+
+	// Reads up to size bytes from offset into dst, which must stay valid until the completion runs
+	Request read(filesystem::Path const& file, unsigned char* dst, size_t size, size_t offset, Completion done,
+				 Priority priority = Priority::Normal);
+
+	// Writes to a temporary file renamed over the destination once complete, a crash never leaves half a file
+	Request write(filesystem::Path const& file, std::vector<unsigned char> data, Completion done,
+				  Priority priority = Priority::Normal);
+
+	// Queued requests are dropped, requests in flight stop at the next chunk. Their completion still runs with
+	// Status::Cancelled. Returns false once the request has completed.
+	bool cancel(Request request);
+
+	void cancel_all();
+
+	void dispatch();
+
+	// Runs on a worker each time a completion is queued, lets a sleeping main loop know dispatch() has work
+	void notify(std::function<void()> callback);
+
+	size_t pending() const;
+
+private:
+	enum class Kind
+	{
+		Read,
+		ReadInto,
+		Write
+	};
+
+	struct Job
+	{
+		Request id;
+		Priority priority;
+		Kind kind;
+		filesystem::Path path;
+		unsigned char* dst;
+		size_t size;
+		size_t offset;
+		std::vector<unsigned char> data;
+		Completion done;
+		std::atomic<bool> cancelled;
+		bool running;
+		Status status;
+		size_t transferred;
+		std::string error;
+	};
+
+	typedef std::pair<int, Request> Key;
+
+	Request submit(std::unique_ptr<Job> job);
+
+	void worker_loop();
+
+	static void run(Job& job);
+
+	mutable std::mutex _mutex;
+	std::condition_variable _wake;
+	std::map<Key, std::shared_ptr<Job>> _queue;
+	std::map<Request, std::shared_ptr<Job>> _jobs;
+	std::vector<std::shared_ptr<Job>> _done;
+	std::vector<std::thread> _workers;
+	std::function<void()> _notify;
+	Request _next;
+	bool _stop;
+};
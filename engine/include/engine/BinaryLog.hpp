@@ -0,0 +1,177 @@
+#pragma once
+
+#include <engine/config.h>
+
+#include <spdlog/spdlog.h>
+#include <spdlog/details/mpmc_bounded_q.h>
+#include <type_traits>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
+
+namespace record
+{
+	// Pointers to one byte integers, sizeof is only taken once the pointee is known to be integral
+	template<typename T, bool Integral = std::is_integral<T>::value>
+	struct IsByte : std::integral_constant<bool, sizeof(T) == 1>
+	{ };
+
+	template<typename T>
+	struct IsByte<T, false> : std::false_type
+	{ };
+
+	template<typename T>
+	struct IsBytePointer : std::false_type
+	{ };
+
+	template<typename T>
+	struct IsBytePointer<T*> : IsByte<typename std::remove_cv<T>::type>
+	{ };
+
+	template<typename T>
+	struct IsText : IsBytePointer<typename std::remove_cv<T>::type>
+	{ };
+
+	// Arguments that can be copied as raw bytes and still mean the same thing on the worker thread
+	template<typename... Args>
+	struct Storable;
+
+	template<>
+	struct Storable<> : std::true_type
+	{ };
+
+	template<typename T, typename... Rest>
+	struct Storable<T, Rest...> : std::integral_constant<bool,
+			std::is_trivially_copyable<T>::value && !std::is_array<T>::value && !IsText<T>::value && Storable<Rest...>::value>
+	{ };
+
+	template<typename... Args>
+	struct Pack;
+
+	template<>
+	struct Pack<>
+	{ };
+
+	template<typename T, typename... Rest>
+	struct Pack<T, Rest...>
+	{
+		T first;
+		Pack<Rest...> rest;
+	};
+
+	inline Pack<> pack()
+	{ return {}; }
+
+	template<typename T, typename... Rest>
+	inline Pack<T, Rest...> pack(T const& first, Rest const& ... rest)
+	{ return {first, pack(rest...)}; }
+
+	template<typename... Done>
+	inline void expand(fmt::MemoryWriter& w, char const* fmt, Pack<> const&, Done const& ... done)
+	{ w.write(fmt, done...); }
+
+	template<typename T, typename... Rest, typename... Done>
+	inline void expand(fmt::MemoryWriter& w, char const* fmt, Pack<T, Rest...> const& p, Done const& ... done)
+	{ expand(w, fmt, p.rest, done..., p.first); }
+}
+
+/*
+ * Logger that keeps formatting off the calling thread.
+ *
+ * When every argument is trivially copyable (numbers, enums, glm vectors...) the call is stored as raw bytes
+ * next to its format string and only formatted by the worker thread. Strings are formatted right away into the
+ * record instead. Only the pointer of the format string is kept, it must be a literal.
+ */
+class ENGINE_API BinaryLog final
+{
+public:
+	static constexpr size_t PayloadSize = 192;
+
+	BinaryLog(std::string const& name, std::vector<spdlog::sink_ptr> const& sinks, size_t queue_size,
+			  spdlog::async_overflow_policy overflow, std::chrono::milliseconds flush_interval);
+
+	~BinaryLog();
+
+	BinaryLog(BinaryLog const& other) = delete;
+
+	BinaryLog& operator=(BinaryLog const& other) = delete;
+
+	template<typename... Args>
+	void log(spdlog::level::level_enum lvl, char const* fmt, Args const& ... args)
+	{
+		Record r;
+		r.level = lvl;
+		r.time = spdlog::details::os::now();
+		r.thread_id = spdlog::details::os::thread_id();
+		r.fmt = fmt;
+		store(r, std::integral_constant<bool, record::Storable<Args...>::value &&
+											  sizeof(record::Pack<Args...>) <= PayloadSize>{}, args...);
+		push(std::move(r));
+	}
+
+	void flush();
+
+	inline size_t dropped() const
+	{ return _dropped.load(std::memory_order_relaxed); }
+
+private:
+	enum class Kind
+	{
+		Packed,
+		Text,
+		OwnedText,
+		Flush,
+		Terminate
+	};
+
+	struct Record
+	{
+		Kind kind;
+		void (* format)(Record const&, fmt::MemoryWriter&);
+		char const* fmt;
+		spdlog::level::level_enum level;
+		spdlog::log_clock::time_point time;
+		size_t thread_id;
+		alignas(std::max_align_t) unsigned char payload[PayloadSize];
+	};
+
+	template<typename... Args>
+	static void format_packed(Record const& r, fmt::MemoryWriter& w)
+	{ record::expand(w, r.fmt, *reinterpret_cast<record::Pack<Args...> const*>(r.payload)); }
+
+	template<typename... Args>
+	static void store(Record& r, std::true_type, Args const& ... args)
+	{
+		r.kind = Kind::Packed;
+		r.format = &format_packed<Args...>;
+		new(r.payload) record::Pack<Args...>(record::pack(args...));
+	}
+
+	template<typename... Args>
+	static void store(Record& r, std::false_type, Args const& ... args)
+	{
+		fmt::MemoryWriter w;
+		w.write(r.fmt, args...);
+		store_text(r, w.data(), w.size());
+	}
+
+	static void store_text(Record& r, char const* text, size_t size);
+
+	void push(Record&& r);
+
+	void worker_loop();
+
+	void write(Record const& r);
+
+	std::string _name;
+	std::vector<spdlog::sink_ptr> _sinks;
+	spdlog::formatter_ptr _formatter;
+	spdlog::details::mpmc_bounded_queue<Record> _q;
+	spdlog::async_overflow_policy _overflow;
+	std::chrono::milliseconds _flush_interval;
+	std::atomic<size_t> _dropped;
+	std::thread _worker;
+};
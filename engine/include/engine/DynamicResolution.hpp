@@ -0,0 +1,92 @@
+#pragma once
+
+#include <engine/resource/Program.hpp>
+#include <engine/config.h>
+#include <engine/Time.hpp>
+
+#include <glm/glm.hpp>
+
+/*
+ * Renders the scene offscreen at a scale adapted to the frame time, then stretches it over the backbuffer.
+ *
+ * The offscreen target is allocated once at the display size and the scene only renders into its lower left
+ * corner, changing the scale never reallocates anything. The upscale is a single textured quad with linear
+ * filtering. Everything drawn after end_scene() (Application::frame_end) lands on the backbuffer at native
+ * resolution, which keeps text and UI sharp. Painter queues its drawing until end_frame(), a painter frame has to
+ * begin and end between begin_scene() and end_scene() (inside Application::frame) to land in the scaled target.
+ *
+ * The scale follows the GPU time of the scene when EXT_disjoint_timer_query is available: it shrinks as soon
+ * as the scene goes over budget and grows again once there is clear headroom. Without timer queries only
+ * missed presents are visible, the scale shrinks on a miss and probes upward after a long run of frames on time.
+ */
+class ENGINE_API DynamicResolution final
+{
+public:
+	DynamicResolution();
+
+	~DynamicResolution();
+
+	DynamicResolution(DynamicResolution const& other) = delete;
+
+	DynamicResolution& operator=(DynamicResolution const& other) = delete;
+
+	// Needs a current GL context, the target is released when disabled
+	void enable(bool enabled = true);
+
+	inline bool enabled() const
+	{ return _enabled; }
+
+	// Scale of each axis, clamped between min_scale and 1
+	void min_scale(float scale);
+
+	inline float min_scale() const
+	{ return _min_scale; }
+
+	inline float scale() const
+	{ return _enabled ? _scale : 1.f; }
+
+	// Pixels actually rendered for the scene
+	inline glm::ivec2 size() const
+	{ return _size; }
+
+	inline bool gpu_timing() const
+	{ return _queries[0] != 0; }
+
+	// Binds the offscreen target and sets the viewport to the scaled size
+	void begin_scene(glm::ivec2 const& display_size);
+
+	// Stretches the scene over the backbuffer, leaving it bound with the native viewport and cleared depth/stencil
+	void end_scene();
+
+	// Feeds the controller once per frame, target is the frame interval to hold
+	void frame_presented(Duration present, Duration target);
+
+private:
+	static const int Queries = 4;
+
+	void allocate(glm::ivec2 const& size);
+
+	void release();
+
+	void adjust(float factor);
+
+	bool _enabled;
+	float _min_scale;
+	float _scale;
+	glm::ivec2 _display;
+	glm::ivec2 _size;
+	glm::uint _framebuffer;
+	glm::uint _color;
+	glm::uint _depth;
+	glm::uint _stencil;
+	Program _program;
+	int _source_location;
+	int _scale_location;
+	int _clamp_location;
+	glm::uint _queries[Queries];
+	int _query_next;
+	int _query_pending;
+	double _gpu_time;
+	int _cooldown;
+	int _on_time;
+};
@@ -1,32 +1,128 @@
 #pragma once
 
+#include <engine/resource/ResourceManager.hpp>
+#include <engine/FileWatcher.hpp>
+#include <engine/AsyncIO.hpp>
+#include <engine/DynamicResolution.hpp>
+#include <engine/FramePacer.hpp>
+#include <engine/BinaryLog.hpp>
 #include <engine/config.h>
 
 #include <spdlog/spdlog.h>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <type_traits>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <list>
 
 class Application;
+class Script;
+class Input;
 
-#ifndef GOBLIN_DISABLE_LOG_MACROS
-#define TRACE(...) Engine::ptr()->log()->trace(__VA_ARGS__)
-#define DEBUG(...) Engine::ptr()->log()->debug(__VA_ARGS__)
-#define INFO(...) Engine::ptr()->log()->info(__VA_ARGS__)
-#define WARN(...) Engine::ptr()->log()->warn(__VA_ARGS__)
-#define ERR(...) Engine::ptr()->log()->error(__VA_ARGS__)
-#define FATAL(...) Engine::ptr()->log()->critical(__VA_ARGS__)
+// Lowest level compiled in, same values as spdlog::level (0 trace, 1 debug ... 6 off)
+#ifdef GOBLIN_DISABLE_LOG_MACROS
+#undef GOBLIN_LOG_LEVEL
+#define GOBLIN_LOG_LEVEL 6
+#elif !defined(GOBLIN_LOG_LEVEL)
+#define GOBLIN_LOG_LEVEL 0
+#endif
+
+// Arguments are only evaluated when the level is enabled at runtime
+#define GOBLIN_LOG(lvl, ...) do { if(Engine::ptr()->should_log(lvl)) Engine::ptr()->write(lvl, __VA_ARGS__); } while(0)
+
+// Still type checks the call so arguments do not become unused, the optimizer drops it entirely
+#define GOBLIN_NO_LOG(...) do { if(false) Engine::ptr()->write(spdlog::level::off, __VA_ARGS__); } while(0)
+
+#if GOBLIN_LOG_LEVEL <= 0
+#define TRACE(...) GOBLIN_LOG(spdlog::level::trace, __VA_ARGS__)
+#else
+#define TRACE(...) GOBLIN_NO_LOG(__VA_ARGS__)
+#endif
+
+#if GOBLIN_LOG_LEVEL <= 1
+#define DEBUG(...) GOBLIN_LOG(spdlog::level::debug, __VA_ARGS__)
+#else
+#define DEBUG(...) GOBLIN_NO_LOG(__VA_ARGS__)
+#endif
+
+#if GOBLIN_LOG_LEVEL <= 2
+#define INFO(...) GOBLIN_LOG(spdlog::level::info, __VA_ARGS__)
+#else
+#define INFO(...) GOBLIN_NO_LOG(__VA_ARGS__)
+#endif
+
+#if GOBLIN_LOG_LEVEL <= 3
+#define WARN(...) GOBLIN_LOG(spdlog::level::warn, __VA_ARGS__)
+#else
+#define WARN(...) GOBLIN_NO_LOG(__VA_ARGS__)
+#endif
+
+#if GOBLIN_LOG_LEVEL <= 4
+#define ERR(...) GOBLIN_LOG(spdlog::level::err, __VA_ARGS__)
+#else
+#define ERR(...) GOBLIN_NO_LOG(__VA_ARGS__)
+#endif
+
+#if GOBLIN_LOG_LEVEL <= 5
+#define FATAL(...) GOBLIN_LOG(spdlog::level::critical, __VA_ARGS__)
 #else
-#define TRACE(...)
-#define DEBUG(...)
-#define INFO(...)
-#define WARN(...)
-#define ERR(...)
-#define FATAL(...)
+#define FATAL(...) GOBLIN_NO_LOG(__VA_ARGS__)
 #endif
 
+struct LogSettings
+{
+	spdlog::level::level_enum level = spdlog::level::trace;
+
+	// Messages waiting for the logging thread, must be a power of two
+	size_t queue_size = 8192;
+
+	// What a full queue does to the calling thread, block_retry waits and discard_log_msg drops the message
+	spdlog::async_overflow_policy overflow = spdlog::async_overflow_policy::block_retry;
+
+	// Sinks are flushed at most this often instead of after every message, zero flushes every message
+	std::chrono::milliseconds flush_interval{250};
+
+	// Defers formatting of the engine macros to the logging thread too, see BinaryLog
+	bool binary = false;
+};
+
+enum class SwapMode
+{
+	Immediate,
+	VSync,
+
+	// Waits for vsync unless the frame is late, then swaps right away and tears instead of waiting a whole
+	// refresh. Falls back to VSync when the driver does not support it.
+	Adaptive
+};
+
+struct DisplaySettings
+{
+	// A zero size or refresh rate keeps the desktop value, the closest mode the display supports is used
+	int width = 1920;
+	int height = 1080;
+	int refresh_rate = 60;
+	bool fullscreen = true;
+
+	// Asks for an OpenGL ES 3.0 context first and falls back to 2.0 when the driver has none
+	bool gles3 = true;
+
+	// Samples per pixel of the backbuffer, 0 or 1 leaves it single sampled. A multisampled backbuffer lets
+	// Painter drop its antialiasing geometry, see Antialias.
+	int msaa_samples = 0;
+
+	SwapMode swap = SwapMode::VSync;
+
+	// Frame rate cap applied before each swap, zero leaves it to the swap mode
+	float max_fps = 0.f;
+
+	// Renders the scene offscreen at a scale adapted to the frame time, see DynamicResolution
+	bool dynamic_resolution = false;
+	float min_render_scale = 0.5f;
+};
+
 class ENGINE_API Engine final
 {
 public:
@@ -39,7 +135,7 @@ public:
 	static inline Engine& ref()
 	{ return *ptr(); }
 
-	Engine(int argc, char** argv);
+	Engine(int argc, char** argv, LogSettings const& settings = LogSettings{});
 
 	virtual ~Engine();
 
@@ -57,13 +153,79 @@ public:
 	inline std::shared_ptr<spdlog::logger> log() const
 	{ return _log; }
 
+	// Mirrors the logger level so the log macros never go through the shared_ptr
+	inline bool should_log(spdlog::level::level_enum lvl) const
+	{ return (int) lvl >= _level.load(std::memory_order_relaxed); }
+
+	inline spdlog::level::level_enum log_level() const
+	{ return static_cast<spdlog::level::level_enum>(_level.load(std::memory_order_relaxed)); }
+
+	void set_log_level(spdlog::level::level_enum lvl);
+
+	template<typename... Args>
+	inline void write(spdlog::level::level_enum lvl, char const* fmt, Args const& ... args)
+	{
+		if(!should_log(lvl))
+			return;
+		if(_records)
+			_records->log(lvl, fmt, args...);
+		else
+			_log->log(lvl, fmt, args...);
+	}
+
+	inline ResourceManager& resources() const
+	{ return *_resources; }
+
+	inline FileWatcher& files() const
+	{ return *_files; }
+
+	inline AsyncIO& io() const
+	{ return *_io; }
+
+	// Keyboard and mouse state as of the last events dispatched
+	inline Input const& input() const
+	{ return *_input; }
+
+	// Created with the window and released right after the application is destroyed, which may still hold sol
+	// references. The painter binding is dropped before that.
+	inline Script& script() const
+	{ return *_script; }
+
 	glm::ivec2 framebuffer_size() const;
 
 	glm::ivec2 window_size() const;
 
+	inline FramePacer& pacer() const
+	{ return *_pacer; }
+
+	inline DynamicResolution& resolution() const
+	{ return *_resolution; }
+
+	// Pixel ratio to hand to Painter::begin_frame for drawing in the scene, that frame must end inside
+	// Application::frame
+	inline float render_scale() const
+	{ return _resolution->scale(); }
+
+	// Returns false when the driver refuses the mode, Adaptive then falls back to VSync
+	bool swap_mode(SwapMode mode);
+
+	inline SwapMode swap_mode() const
+	{ return _swap_mode; }
+
+	// The context is OpenGL ES 3.0 or newer and its entry points are loaded (glad/glad_es3.h)
+	inline bool gles3() const
+	{ return _gles3; }
+
+	// Samples per pixel the backbuffer actually got, 0 when single sampled
+	inline int msaa_samples() const
+	{ return _msaa_samples; }
+
 	inline float pixel_ratio() const
 	{ return (float) framebuffer_size().x / (float) window_size().x; }
 
+	// Draws the next frame in on demand mode, see Application::on_demand. Safe to call from any thread.
+	void request_redraw();
+
 	inline void exit(int code = 0)
 	{
 		_running = false;
@@ -73,12 +235,30 @@ public:
 private:
 	static std::unique_ptr<Engine> _inst;
 
-	int run(Application* app);
+	int run(Application* app, DisplaySettings const& display);
+
+	void wake();
+
+	void wait(Application const& app, Duration accumulator, TimePoint last_time);
 
 	std::shared_ptr<spdlog::logger> _log;
+	std::unique_ptr<BinaryLog> _records;
+	std::atomic<int> _level;
+	std::unique_ptr<ResourceManager> _resources;
+	std::unique_ptr<FileWatcher> _files;
+	std::unique_ptr<AsyncIO> _io;
+	std::unique_ptr<Script> _script;
+	std::unique_ptr<Input> _input;
+	std::unique_ptr<FramePacer> _pacer;
+	std::unique_ptr<DynamicResolution> _resolution;
 	std::list<std::string> _args;
 	int _exit_code;
 	bool _running;
+	std::atomic<bool> _redraw;
+	SwapMode _swap_mode;
+	glm::uint _wake_event;
+	bool _gles3;
+	int _msaa_samples;
 
 	struct SDL_Window* _wnd;
 };
@@ -91,6 +271,6 @@ inline int Engine::run(int argc, char* argv[])
 	static_assert(std::is_base_of<Application, AppType>::value, "AppType must be a subclass of Application");
 	static_assert(std::is_constructible<AppType>::value, "AppType must have an empty constructor");
 
-	_inst = std::make_unique<Engine>(argc, argv);
-	return _inst->run(new AppType);
+	_inst = std::make_unique<Engine>(argc, argv, AppType::log_settings());
+	return _inst->run(new AppType, AppType::display_settings());
 }
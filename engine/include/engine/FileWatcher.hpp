@@ -0,0 +1,85 @@
+#pragma once
+
+#include <engine/utils/FileSystem.hpp>
+#include <engine/config.h>
+#include <engine/Time.hpp>
+
+#include <glm/glm.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+#include <map>
+
+/*
+ * Reports changes to watched files, polled once per frame from the main loop.
+ *
+ * On Linux the parent directories are watched through inotify so files replaced by a rename (the way most
+ * editors save) are still picked up, elsewhere modification times are compared every interval. Bursts of
+ * events on a file are coalesced, callbacks only run once the file has been quiet for the settle delay.
+ */
+class ENGINE_API FileWatcher final
+{
+public:
+	typedef glm::uint Watch;
+
+	typedef std::function<void(filesystem::Path const&)> Callback;
+
+	static const Watch Invalid = 0;
+
+	explicit FileWatcher(Duration settle = std::chrono::milliseconds(100), Duration interval = std::chrono::milliseconds(500));
+
+	~FileWatcher();
+
+	FileWatcher(FileWatcher const& other) = delete;
+
+	FileWatcher& operator=(FileWatcher const& other) = delete;
+
+	// Returns Invalid without watching anything while the watcher is disabled
+	Watch watch(filesystem::Path const& file, Callback callback);
+
+	void unwatch(Watch watch);
+
+	void poll();
+
+	void enable(bool enabled = true);
+
+	inline bool enabled() const
+	{ return _enabled; }
+
+	inline bool native() const
+	{ return _fd >= 0; }
+
+	inline size_t size() const
+	{ return _entries.size(); }
+
+	inline Duration settle() const
+	{ return _settle; }
+
+private:
+	struct Entry
+	{
+		filesystem::Path path;
+		std::string key;
+		std::string dir;
+		std::string name;
+		int wd;
+		long long mtime;
+		long long size;
+		Callback callback;
+	};
+
+	void read_events(TimePoint now);
+
+	void scan(TimePoint now);
+
+	void release(int wd);
+
+	Duration _settle;
+	Duration _interval;
+	TimePoint _last_scan;
+	std::map<Watch, Entry> _entries;
+	std::map<std::string, TimePoint> _pending;
+	Watch _next;
+	int _fd;
+	bool _enabled;
+};
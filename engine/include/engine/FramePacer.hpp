@@ -0,0 +1,76 @@
+#pragma once
+
+#include <engine/config.h>
+#include <engine/Time.hpp>
+
+#include <vector>
+
+/*
+ * Caps the frame rate and measures the time between presents.
+ *
+ * wait() runs right before the swap. It sleeps until shortly before the next frame is due and spins the rest
+ * of the way, sleeping alone overshoots by up to a scheduler tick. Deadlines follow each other at the target
+ * interval rather than being taken from the previous present, so the rate does not drift. After a long stall
+ * the schedule restarts from now instead of rushing frames to catch up.
+ */
+class ENGINE_API FramePacer final
+{
+public:
+	struct Stats
+	{
+		Duration last;
+		Duration average;
+		Duration min;
+		Duration max;
+		float fps;
+
+		// Presents of the window that came later than one and a half target intervals, the target being the cap
+		// when there is one and the display refresh otherwise
+		size_t missed;
+		size_t frames;
+	};
+
+	// Intervals kept for the average, min, max and missed count
+	static const size_t Window = 120;
+
+	explicit FramePacer(float max_fps = 0.f, Duration spin = std::chrono::microseconds(1500));
+
+	FramePacer(FramePacer const& other) = delete;
+
+	FramePacer& operator=(FramePacer const& other) = delete;
+
+	// Zero or less removes the cap
+	void max_fps(float fps);
+
+	inline float max_fps() const
+	{ return _max_fps; }
+
+	// Used to count missed frames when there is no cap
+	void refresh_rate(float hz);
+
+	void wait();
+
+	void presented();
+
+	// The next interval is not recorded, for a loop that was idle on purpose
+	void reset();
+
+	inline Stats const& stats() const
+	{ return _stats; }
+
+	// Interval each frame should take, the cap when there is one and the display refresh otherwise
+	Duration target() const;
+
+private:
+	float _max_fps;
+	float _refresh_rate;
+	Duration _interval;
+	Duration _spin;
+	TimePoint _deadline;
+	TimePoint _last_present;
+	bool _has_present;
+	std::vector<Duration> _intervals;
+	std::vector<bool> _late;
+	size_t _next;
+	Stats _stats;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <engine/config.h>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+/*
+ * Engine wide cache of the current GL context state.
+ *
+ * Every bind, enable and attribute pointer issued by the engine (Painter, Buffer, VertexArray, ...) goes
+ * through here so redundant changes never reach the driver. Code issuing raw GL state calls must call
+ * invalidate() afterwards so the cache does not go out of sync.
+ */
+class ENGINE_API GLState final
+{
+	GLState()
+	{ }
+
+public:
+	struct Stats
+	{
+		glm::uint changes;  // State changes forwarded to GL
+		glm::uint filtered; // Redundant state changes that were dropped
+	};
+
+	static void invalidate();
+
+	static void end_frame();
+
+	static Stats const& frame_stats();
+
+	static void enable(GLenum cap, bool enabled = true);
+
+	static inline void disable(GLenum cap)
+	{ enable(cap, false); }
+
+	// Answered from the cache when known, asks GL otherwise
+	static bool enabled(GLenum cap);
+
+	static void use_program(GLuint program);
+
+	static void bind_buffer(GLenum target, GLuint buffer);
+
+	static void active_texture(GLenum unit);
+
+	static void bind_texture(GLenum target, GLuint texture);
+
+	static void blend_func(GLenum src, GLenum dst);
+
+	static void cull_face(GLenum mode);
+
+	static void front_face(GLenum mode);
+
+	static void color_mask(bool r, bool g, bool b, bool a);
+
+	static void stencil_mask(GLuint mask);
+
+	static void stencil_func(GLenum func, GLint ref, GLuint mask);
+
+	static void stencil_op(GLenum sfail, GLenum dpfail, GLenum dppass);
+
+	static void stencil_op_separate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass);
+
+	static void enable_attribute(GLuint index, bool enabled = true);
+
+	static inline void disable_attribute(GLuint index)
+	{ enable_attribute(index, false); }
+
+	static void attribute_pointer(GLuint index, GLint size, GLenum type, bool normalized, GLsizei stride, void const* ptr);
+
+	// Enables exactly the attribute arrays set in the mask, disabling every other one
+	static void enable_attributes(glm::uint mask);
+
+	// Whole vertex layouts (see VertexLayout), identified by an address unique to each layout
+	static bool layout_current(void const* layout, glm::int64 base);
+
+	static void layout_applied(void const* layout, glm::int64 base);
+
+	// Attribute arrays and the element buffer belong to the array bound, their cache is dropped when it changes.
+	// Array 0 is the only one there is without ES 3.0 or OES_vertex_array_object.
+	static void bind_vertex_array(GLuint array);
+
+	static void delete_buffers(GLsizei n, GLuint const* buffers);
+
+	static void delete_textures(GLsizei n, GLuint const* textures);
+
+	static void delete_program(GLuint program);
+
+	static void delete_vertex_arrays(GLsizei n, GLuint const* arrays);
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <engine/InputEnums.hpp>
+#include <engine/config.h>
+
+#include <glm/glm.hpp>
+#include <bitset>
+
+class Application;
+class Script;
+union SDL_Event;
+
+/*
+ * Reads the SDL event queue for the main loop and keeps a snapshot of the keyboard and mouse state.
+ *
+ * Mouse motion arrives far more often than frames on high rate mice and touch panels. Motion events in a row
+ * are merged into one mouse_move with the summed delta, a motion is only dispatched on its own when another
+ * event comes between, so the order against buttons and keys is kept.
+ *
+ * resample() runs after update, right before rendering, and dispatches the motion queued in the meantime.
+ * Drawing then follows the pointer as it is when the frame starts instead of when the loop iteration started.
+ */
+class ENGINE_API Input final
+{
+public:
+	// Matches SDL_NUM_SCANCODES
+	static const size_t KeyCount = 512;
+
+	Input();
+
+	Input(Input const& other) = delete;
+
+	Input& operator=(Input const& other) = delete;
+
+	// Starts a new frame, drains the queue and dispatches to the application then the script
+	void process(Application& app, Script& script);
+
+	// Only takes the motion at the front of the queue, anything behind another event waits for the next frame
+	void resample(Application& app, Script& script);
+
+	// Forgets the state of a previous run, including a quit request. coalesce_motion is kept.
+	void reset();
+
+	inline void coalesce_motion(bool enabled)
+	{ _coalesce = enabled; }
+
+	inline bool coalesce_motion() const
+	{ return _coalesce; }
+
+	inline bool quit_requested() const
+	{ return _quit; }
+
+	inline bool key_down(Key key) const
+	{ return _keys.test(index(key)); }
+
+	// Went down or up during the current frame
+	inline bool key_pressed(Key key) const
+	{ return _pressed.test(index(key)); }
+
+	inline bool key_released(Key key) const
+	{ return _released.test(index(key)); }
+
+	inline bool button_down(MouseButton button) const
+	{ return (_buttons & mask(button)) != 0; }
+
+	inline bool button_pressed(MouseButton button) const
+	{ return (_buttons_pressed & mask(button)) != 0; }
+
+	inline bool button_released(MouseButton button) const
+	{ return (_buttons_released & mask(button)) != 0; }
+
+	inline glm::ivec2 mouse_position() const
+	{ return _position; }
+
+	// Summed over the current frame, including what resample() picked up
+	inline glm::ivec2 mouse_delta() const
+	{ return _delta; }
+
+	inline glm::ivec2 scroll_delta() const
+	{ return _scroll; }
+
+	// Motion events read and mouse_move calls made during the current frame
+	inline size_t motion_events() const
+	{ return _motion_events; }
+
+	inline size_t motion_dispatched() const
+	{ return _motion_dispatched; }
+
+private:
+	static inline size_t index(Key key)
+	{ return static_cast<size_t>(key) % KeyCount; }
+
+	static inline unsigned mask(MouseButton button)
+	{ return 1u << static_cast<unsigned>(button); }
+
+	void handle(SDL_Event const& e, Application& app, Script& script);
+
+	void motion(glm::ivec2 const& position, glm::ivec2 const& delta, Application& app, Script& script);
+
+	void flush_motion(Application& app, Script& script);
+
+	std::bitset<KeyCount> _keys;
+	std::bitset<KeyCount> _pressed;
+	std::bitset<KeyCount> _released;
+	unsigned _buttons;
+	unsigned _buttons_pressed;
+	unsigned _buttons_released;
+	glm::ivec2 _position;
+	glm::ivec2 _delta;
+	glm::ivec2 _scroll;
+	glm::ivec2 _pending;
+	bool _has_pending;
+	bool _coalesce;
+	bool _quit;
+	size_t _motion_events;
+	size_t _motion_dispatched;
+};
@@ -1,12 +1,20 @@
 #pragma once
 
 #include <engine/utils/BitmaskOperators.hpp>
+#include <engine/utils/FileSystem.hpp>
+#include <engine/VideoTexture.hpp>
+#include <engine/FileWatcher.hpp>
 #include <engine/config.h>
 
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
+#include <memory>
 #include <array>
+#include <map>
+
+class Archive;
+class Series;
 
 enum class Winding
 {
@@ -62,12 +70,41 @@ struct TextMetrics
 	float acender, descender, line_height;
 };
 
+// A string for Painter::text_batch, end can be left null for a null terminated string
+struct TextLabel
+{
+	glm::vec2 position;
+	char const* text;
+	char const* end;
+};
+
 struct TextRow
 {
 	std::string text;
 	float width, min_x, max_x;
 };
 
+// Values of NVGpathCommand, see Painter::path
+enum class PathCommand : unsigned char
+{
+	MoveTo = 0,   // One point
+	LineTo = 1,   // One point
+	BezierTo = 2, // Three points, both controls then the end
+	Close = 3     // No point
+};
+
+enum class Antialias
+{
+	// Multisample when the backbuffer is multisampled and the scene is not rendered offscreen, Geometry otherwise
+	Auto,
+
+	// A one pixel fringe of extra geometry along every edge
+	Geometry,
+
+	// Plain geometry, edges are left to a multisampled framebuffer (DisplaySettings::msaa_samples)
+	Multisample
+};
+
 struct Paint
 {
 	glm::mat2x3 transform;
@@ -82,7 +119,16 @@ class ENGINE_API Painter final
 	friend class Blendish;
 
 public:
-	Painter();
+	// Geometry submitted since begin_frame, kept after end_frame until the next one
+	struct Stats
+	{
+		int draw_calls;
+		int triangles;
+		int vertices;
+	};
+
+	// Needs a current GL context
+	explicit Painter(Antialias antialias = Antialias::Auto);
 
 	~Painter();
 
@@ -100,6 +146,12 @@ public:
 
 	void end_frame();
 
+	// Never Auto, the mode picked at construction
+	inline Antialias antialias() const
+	{ return _antialias; }
+
+	Stats frame_stats() const;
+
 	void save();
 
 	void restore();
@@ -144,10 +196,36 @@ public:
 
 	int create_image(unsigned char const* data, int size, ImageFlags flags);
 
+	int create_image(filesystem::MappedFile const& file, ImageFlags flags);
+
+	int create_image(Archive const& archive, std::string const& file, ImageFlags flags);
+
+	// Decodes the file again into the same image, fails when the dimensions changed
+	bool reload_image(int id, std::string const& file);
+
 	glm::ivec2 image_size(int id);
 
 	void delete_image(int id);
 
+	// Raw RGBA pixels, rows from the top, null leaves the content undefined until the first update
+	int create_image(glm::ivec2 const& size, unsigned char const* pixels, ImageFlags flags);
+
+	// Uploads every pixel again, pixels holds the whole image
+	void update_image(int id, unsigned char const* pixels);
+
+	// Uploads only the rectangle that changed, pixels still holds the whole image
+	void update_image(int id, unsigned char const* pixels, glm::ivec2 const& pos, glm::ivec2 const& size);
+
+	// Image converted from YUV planes on the GPU by each update_video_image, drawn through image_pattern like any
+	// other. Throws when the conversion target cannot be built.
+	int create_video_image(glm::ivec2 const& size, PlaneFormat format, ImageFlags flags = ImageFlags::None);
+
+	// Planes and strides as for VideoTexture::update
+	void update_video_image(int id, unsigned char const* const* planes, int const* strides = nullptr);
+
+	// Null when the image does not come from create_video_image
+	VideoTexture* video_image(int id);
+
 	void scissor(glm::vec2 const& pos, glm::vec2 const& size);
 
 	void intersect_scissor(glm::vec2 const& pos, glm::vec2 const& size);
@@ -184,8 +262,44 @@ public:
 
 	void stroke();
 
+	// Appends a whole path in one call, each command taking its points in order. The points are transformed in
+	// a single pass, commands left without enough points are dropped.
+	void path(PathCommand const* commands, size_t count, glm::vec2 const* points, size_t point_count);
+
+	inline void path(std::vector<PathCommand> const& commands, std::vector<glm::vec2> const& points)
+	{ path(commands.data(), commands.size(), points.data(), points.size()); }
+
+	// move_to the first point and line_to through the others, in one call
+	void line_strip(glm::vec2 const* points, size_t count);
+
+	inline void line_strip(std::vector<glm::vec2> const& points)
+	{ line_strip(points.data(), points.size()); }
+
+	// Adds a line through points sorted by increasing x to the current path. Only the visible part is added,
+	// decimated to the first, lowest, highest and last point of each pixel column when the transform does not
+	// rotate or skew, so the path stays around four points per column however many there are.
+	void polyline(glm::vec2 const* points, size_t count);
+
+	// Same using the pyramid of the series, the cost follows the screen width rather than the visible points
+	void polyline(Series const& series);
+
+	inline void polyline(std::vector<glm::vec2> const& points)
+	{ polyline(points.data(), points.size()); }
+
 	int create_font(std::string const& name, std::string const& file);
 
+	// The font is read straight from data, which must stay valid as long as the painter
+	int create_font(std::string const& name, unsigned char const* data, int size);
+
+	// The data is copied out of the mapping, the file may be rewritten in place afterwards
+	int create_font(std::string const& name, filesystem::MappedFile const& file);
+
+	// Stored entries are used in place, the archive must then outlive the painter and only be replaced by rename
+	int create_font(std::string const& name, Archive const& archive, std::string const& file);
+
+	// Swaps the font data in place, handles and names stay valid
+	bool reload_font(int id, std::string const& file);
+
 	int find_font(std::string const& name);
 
 	void font_size(float size);
@@ -204,6 +318,16 @@ public:
 
 	float text(glm::vec2 const& pos, std::string const& str);
 
+	// Draws every label with the current font, alignment and fill in a single draw call. The strings are only
+	// read during the call.
+	void text_batch(TextLabel const* labels, size_t count);
+
+	inline void text_batch(std::vector<TextLabel> const& labels)
+	{ text_batch(labels.data(), labels.size()); }
+
+	// Labels at matching indices, extra positions or strings are ignored
+	void text_batch(std::vector<glm::vec2> const& positions, std::vector<std::string> const& strings);
+
 	void text_box(glm::vec2 const& pos, float width, std::string const& str);
 
 	float text_bounds(glm::vec2 const& pos, std::string const& str, glm::vec2& min, glm::vec2& max);
@@ -234,5 +358,19 @@ public:
 	}
 
 private:
+	// Range of points to draw and the mapping of x to device pixel columns, false when columns do not follow x
+	bool visible_columns(glm::vec2 const* points, size_t count, size_t& begin, size_t& end, glm::vec2& columns) const;
+
+	void watch(std::map<int, FileWatcher::Watch>& watches, int id, std::string const& file, bool font);
+
 	struct NVGcontext* _vg;
+	bool _gles3;
+	Antialias _antialias;
+	glm::ivec2 _frame_size;
+	float _pixel_ratio;
+	std::vector<glm::vec2> _decimated;
+	std::vector<TextLabel> _labels;
+	std::map<int, std::unique_ptr<VideoTexture>> _videos;
+	std::map<int, FileWatcher::Watch> _image_watches;
+	std::map<int, FileWatcher::Watch> _font_watches;
 };
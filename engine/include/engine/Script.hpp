@@ -0,0 +1,92 @@
+#pragma once
+
+#include <engine/utils/FileSystem.hpp>
+#include <engine/utils/Sol.hpp>
+#include <engine/FileWatcher.hpp>
+#include <engine/InputEnums.hpp>
+#include <engine/config.h>
+#include <engine/Time.hpp>
+
+#include <glm/glm.hpp>
+#include <string>
+
+class Painter;
+
+/*
+ * Lua state owned by the engine, with bindings for glm vectors, Painter and the input callbacks.
+ *
+ * Vectors are usertypes, bound functions read them in place from the userdata and the painter is exposed by
+ * pointer, so nothing is copied on the way in. Painter calls also take plain numbers (circle(x, y, r)) which
+ * avoids creating a vector in Lua for every call. The positions handed to the input callbacks live on the C++
+ * side and are pushed once as references, dispatching an event only updates them and never allocates in Lua.
+ *
+ * Scripts define any of the global functions update(dt), frame(), mouse_button(pos, button, pressed),
+ * mouse_move(delta), scroll(delta), keyboard(key, pressed) and character(text). The engine calls them right
+ * after the matching Application method, frame() runs between Application::frame() and frame_end() and paints
+ * into whatever painter frame the application left open.
+ */
+class ENGINE_API Script final
+{
+public:
+	Script();
+
+	~Script();
+
+	Script(Script const& other) = delete;
+
+	Script& operator=(Script const& other) = delete;
+
+	// Runs the file and picks up its callbacks, errors are logged and keep the previous callbacks.
+	// With hot reload enabled the file runs again in the same state whenever it changes.
+	bool load(filesystem::Path const& file);
+
+	bool run(std::string const& code, std::string const& name = "chunk");
+
+	// Exposes the painter as the global 'painter', it must outlive the script or be unbound with nullptr
+	void bind(Painter* painter);
+
+	void update(Duration dT);
+
+	void frame();
+
+	void mouse_button(glm::ivec2 const& pos, MouseButton button, bool pressed);
+
+	void mouse_move(glm::ivec2 const& delta);
+
+	void scroll(glm::ivec2 const& delta);
+
+	void keyboard(Key key, bool pressed);
+
+	void character(char const* text);
+
+	inline sol::state& lua()
+	{ return _lua; }
+
+private:
+	void bind_glm();
+
+	void bind_painter();
+
+	void fetch_callbacks();
+
+	template<typename... Args>
+	void call(sol::protected_function& function, char const* name, Args&& ... args);
+
+	sol::state _lua;
+
+	sol::protected_function _update;
+	sol::protected_function _frame;
+	sol::protected_function _mouse_button;
+	sol::protected_function _mouse_move;
+	sol::protected_function _scroll;
+	sol::protected_function _keyboard;
+	sol::protected_function _character;
+
+	glm::vec2 _position;
+	glm::vec2 _delta;
+	sol::object _position_ref;
+	sol::object _delta_ref;
+
+	filesystem::Path _file;
+	FileWatcher::Watch _watch;
+};
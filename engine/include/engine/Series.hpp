@@ -0,0 +1,68 @@
+#pragma once
+
+#include <engine/config.h>
+
+#include <glm/glm.hpp>
+#include <vector>
+
+/*
+ * Points of a time series, x increasing, with a min/max pyramid for drawing it at any zoom (Painter::polyline).
+ *
+ * Each node of level 0 summarizes Fanout consecutive points, each node of level n summarizes Fanout nodes of
+ * level n - 1: the first and last points it covers and the points with the lowest and highest y. Drawing picks
+ * the coarsest level whose nodes still fit in a pixel column, so the work follows the screen width rather than
+ * the number of points.
+ *
+ * append() keeps the pyramid current, only the last node of each level changes.
+ */
+class ENGINE_API Series final
+{
+public:
+	struct Node
+	{
+		glm::vec2 first;
+		glm::vec2 low;
+		glm::vec2 high;
+		glm::vec2 last;
+	};
+
+	// Points or nodes summarized by each node of the level above
+	static const size_t Fanout = 4;
+
+	Series();
+
+	explicit Series(std::vector<glm::vec2> points);
+
+	void append(glm::vec2 const& point);
+
+	void append(glm::vec2 const* points, size_t count);
+
+	void clear();
+
+	inline std::vector<glm::vec2> const& points() const
+	{ return _points; }
+
+	inline size_t size() const
+	{ return _points.size(); }
+
+	inline bool empty() const
+	{ return _points.empty(); }
+
+	inline size_t levels() const
+	{ return _levels.size(); }
+
+	inline std::vector<Node> const& level(size_t index) const
+	{ return _levels[index]; }
+
+	// Points covered by each node of the level
+	static size_t span(size_t level);
+
+	// First point with an x not below the given one
+	size_t lower_bound(float x) const;
+
+private:
+	void grow();
+
+	std::vector<glm::vec2> _points;
+	std::vector<std::vector<Node>> _levels;
+};
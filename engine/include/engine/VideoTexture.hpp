@@ -0,0 +1,79 @@
+#pragma once
+
+#include <engine/resource/Program.hpp>
+#include <engine/config.h>
+
+#include <glm/glm.hpp>
+
+enum class PlaneFormat
+{
+	// Full resolution Y plane then one half resolution plane of interleaved U and V
+	NV12,
+
+	// Full resolution Y plane then half resolution U and V planes
+	I420
+};
+
+/*
+ * RGBA texture fed with YUV frames, for camera and video sources.
+ *
+ * Each plane is uploaded as is into its own luminance (or luminance alpha for the interleaved chroma of NV12)
+ * texture, then a fragment shader converts the three channels to RGB while drawing them into the RGBA texture.
+ * The CPU never touches the pixels and the upload is half the size of the RGBA frame. The conversion runs once
+ * per update whatever the number of times the frame is drawn, Painter wraps texture() as a regular image
+ * (Painter::create_video_image).
+ *
+ * Rows may be padded, strides that are not the plane width are unpacked by GL when it can (GLES3 or
+ * EXT_unpack_subimage) and uploaded row by row otherwise.
+ */
+class ENGINE_API VideoTexture final
+{
+public:
+	VideoTexture();
+
+	~VideoTexture();
+
+	VideoTexture(VideoTexture const& other) = delete;
+
+	VideoTexture& operator=(VideoTexture const& other) = delete;
+
+	// Needs a current GL context, throws when the conversion target cannot be built
+	void create(glm::ivec2 const& size, PlaneFormat format);
+
+	void destroy();
+
+	// NV12 reads planes 0 (Y) and 1 (UV), I420 planes 0 (Y), 1 (U) and 2 (V). Strides are in bytes, null or zero
+	// for rows without padding. The bound framebuffer and viewport are restored afterwards.
+	void update(unsigned char const* const* planes, int const* strides = nullptr);
+
+	// BT.601 with Y in 16-235 by default, full range 0-255 for JPEG style sources
+	inline void full_range(bool full)
+	{ _full_range = full; }
+
+	inline bool full_range() const
+	{ return _full_range; }
+
+	inline glm::uint texture() const
+	{ return _color; }
+
+	inline glm::ivec2 size() const
+	{ return _size; }
+
+	inline PlaneFormat format() const
+	{ return _format; }
+
+private:
+	static const int Planes = 3;
+
+	void upload(int plane, unsigned char const* data, int stride);
+
+	glm::ivec2 _size;
+	PlaneFormat _format;
+	bool _full_range;
+	glm::uint _framebuffer;
+	glm::uint _color;
+	glm::uint _planes[Planes];
+	Program _program;
+	int _offset_location;
+	int _matrix_location;
+};
@@ -37,6 +37,8 @@ public:
 
 	virtual void destroy() override;
 
+	static void release_recycled();
+
 	static void bind(Target const& target, glm::uint id);
 
 	static void unbind(Target const& target);
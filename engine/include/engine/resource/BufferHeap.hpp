@@ -0,0 +1,103 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <map>
+
+#include "Buffer.hpp"
+
+/*
+ * Sub-allocates ranges of a few large GL buffers (pages) so many small meshes share the same buffer objects.
+ *
+ * Allocations are identified by a stable id, their page and offset are looked up with range() since
+ * defragment() may move them around. Moving data requires a CPU side copy of the pages (keep_shadow),
+ * without it defragment() only gives empty pages back to GL.
+ */
+class ENGINE_API BufferHeap final
+{
+public:
+	typedef glm::uint Allocation;
+
+	static const Allocation Invalid = 0;
+
+	struct Range
+	{
+		glm::uint buffer;
+		glm::int64 offset;
+		glm::int64 size;
+	};
+
+	struct Stats
+	{
+		size_t pages;
+		size_t allocations;
+		size_t free_blocks;
+		glm::int64 capacity;
+		glm::int64 used;
+		glm::int64 largest_free;
+	};
+
+	BufferHeap(Buffer::Target target, Buffer::Usage usage, glm::int64 page_size = 1 << 20, glm::int64 alignment = 16, bool keep_shadow = false);
+
+	~BufferHeap();
+
+	BufferHeap(BufferHeap const& other) = delete;
+
+	BufferHeap(BufferHeap&& other) = default;
+
+	BufferHeap& operator=(BufferHeap const& other) = delete;
+
+	BufferHeap& operator=(BufferHeap&& other) = default;
+
+	Allocation allocate(glm::int64 size);
+
+	void free(Allocation alloc);
+
+	void upload(Allocation alloc, void const* ptr, glm::int64 size, glm::int64 offset = 0);
+
+	template<typename T>
+	inline Allocation allocate(std::vector<T> const& vector)
+	{
+		Allocation alloc = allocate((glm::int64) vector.size() * (glm::int64) sizeof(T));
+		upload(alloc, &vector[0], (glm::int64) vector.size() * (glm::int64) sizeof(T));
+		return alloc;
+	}
+
+	Range range(Allocation alloc) const;
+
+	void bind(Allocation alloc) const;
+
+	void defragment();
+
+	Stats stats() const;
+
+private:
+	struct Page
+	{
+		Buffer buffer;
+		glm::int64 size;
+		std::map<glm::int64, glm::int64> free; // offset -> size, coalesced
+		std::vector<unsigned char> shadow;
+		size_t live;
+	};
+
+	struct Block
+	{
+		size_t page;
+		glm::int64 offset;
+		glm::int64 size;
+	};
+
+	size_t add_page(glm::int64 size);
+
+	void release(Page& page, glm::int64 offset, glm::int64 size);
+
+	Buffer::Target _target;
+	Buffer::Usage _usage;
+	glm::int64 _page_size;
+	glm::int64 _alignment;
+	bool _keep_shadow;
+	std::vector<std::unique_ptr<Page>> _pages;
+	std::map<Allocation, Block> _blocks;
+	Allocation _next;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <engine/utils/FileSystem.hpp>
+
+#include <utility>
+#include <string>
+#include <vector>
+
+#include "Resource.hpp"
+
+class ENGINE_API Program : public Resource
+{
+public:
+	typedef std::vector<std::pair<glm::uint, std::string>> AttributeBindings;
+
+	Program();
+
+	virtual ~Program();
+
+	Program(Program const& other) = delete;
+
+	Program(Program&& other) = default;
+
+	Program& operator=(Program const& other) = delete;
+
+	Program& operator=(Program&& other) = default;
+
+	virtual void create() override;
+
+	virtual void destroy() override;
+
+	void build(std::string const& vertex, std::string const& fragment, AttributeBindings const& attributes = {});
+
+	void use() const;
+
+	int uniform_location(std::string const& name) const;
+
+	int attribute_location(std::string const& name) const;
+
+	inline bool from_cache() const
+	{ return _from_cache; }
+
+	static glm::uint link(std::string const& vertex, std::string const& fragment, AttributeBindings const& attributes, bool* from_cache = nullptr);
+
+	static void cache_directory(filesystem::Path const& dir);
+
+	static filesystem::Path const& cache_directory();
+
+private:
+	bool _from_cache;
+};
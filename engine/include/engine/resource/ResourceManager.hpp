@@ -0,0 +1,121 @@
+#pragma once
+
+#include <type_traits>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+#include "Resource.hpp"
+
+struct RawHandle
+{
+	glm::uint index;
+	glm::uint generation;
+};
+
+template<class T>
+struct Handle
+{
+	glm::uint index;
+	glm::uint generation; // 0 is never a live generation, a default constructed handle is always invalid
+
+	inline Handle() : index(0), generation(0)
+	{ }
+
+	inline explicit Handle(RawHandle const& raw) : index(raw.index), generation(raw.generation)
+	{ }
+
+	inline RawHandle raw() const
+	{ return {index, generation}; }
+
+	inline bool valid() const
+	{ return generation != 0; }
+
+	inline bool operator==(Handle const& other) const
+	{ return index == other.index && generation == other.generation; }
+
+	inline bool operator!=(Handle const& other) const
+	{ return !(*this == other); }
+};
+
+/*
+ * Owns resources behind generational handles.
+ *
+ * Handles can be copied, acquired and released from any thread. When the last reference goes away the
+ * handle becomes stale right away, but the resource itself is only destroyed by collect() on the GL thread,
+ * once the frames that may still use it have been presented.
+ */
+class ENGINE_API ResourceManager final
+{
+public:
+	explicit ResourceManager(glm::uint frames_in_flight = 2);
+
+	~ResourceManager();
+
+	ResourceManager(ResourceManager const& other) = delete;
+
+	ResourceManager& operator=(ResourceManager const& other) = delete;
+
+	template<class T, class... Args>
+	Handle<T> create(Args&& ... args)
+	{
+		static_assert(std::is_base_of<Resource, T>::value, "T must be a subclass of Resource");
+		std::unique_ptr<T> res{new T(std::forward<Args>(args)...)};
+		res->create();
+		return Handle<T>{insert(std::move(res))};
+	}
+
+	template<class T>
+	Handle<T> adopt(std::unique_ptr<T> res)
+	{
+		static_assert(std::is_base_of<Resource, T>::value, "T must be a subclass of Resource");
+		return Handle<T>{insert(std::move(res))};
+	}
+
+	template<class T>
+	T* get(Handle<T> const& handle) const
+	{ return static_cast<T*>(lookup(handle.raw())); }
+
+	template<class T>
+	bool alive(Handle<T> const& handle) const
+	{ return lookup(handle.raw()) != nullptr; }
+
+	template<class T>
+	void acquire(Handle<T> const& handle)
+	{ retain(handle.raw()); }
+
+	template<class T>
+	void release(Handle<T> const& handle)
+	{ drop(handle.raw()); }
+
+	void collect();
+
+	void clear();
+
+	size_t size() const;
+
+	size_t pending() const;
+
+private:
+	struct Slot
+	{
+		std::unique_ptr<Resource> resource;
+		glm::uint generation;
+		glm::uint references;
+	};
+
+	RawHandle insert(std::unique_ptr<Resource> res);
+
+	Resource* lookup(RawHandle const& handle) const;
+
+	void retain(RawHandle const& handle);
+
+	void drop(RawHandle const& handle);
+
+	mutable std::mutex _mutex;
+	std::vector<Slot> _slots;
+	std::vector<glm::uint> _free;
+	std::vector<std::vector<std::unique_ptr<Resource>>> _retired;
+	glm::uint64 _frame;
+	size_t _live;
+};
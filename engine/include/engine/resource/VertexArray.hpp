@@ -2,11 +2,17 @@
 
 #include <glm/glm.hpp>
 
-class VertexArray
-{
-	VertexArray()
-	{ }
+#include "Resource.hpp"
 
+/*
+ * Vertex array object, the buffers and attribute layout of a mesh recorded once by setup() and restored by a
+ * single bind() afterwards.
+ *
+ * Without ES 3.0 or OES_vertex_array_object there is no GL object behind it, bind() then replays the recorded
+ * buffers and layout through GLState, which skips whatever is already current.
+ */
+class ENGINE_API VertexArray : public Resource
+{
 public:
 	enum class Type
 	{
@@ -35,6 +41,40 @@ public:
 		Triangles = 0x0004
 	};
 
+	VertexArray();
+
+	virtual ~VertexArray();
+
+	VertexArray(VertexArray const& other) = delete;
+
+	VertexArray(VertexArray&& other) = default;
+
+	VertexArray& operator=(VertexArray const& other) = delete;
+
+	VertexArray& operator=(VertexArray&& other) = default;
+
+	virtual void create() override;
+
+	virtual void destroy() override;
+
+	static bool supported();
+
+	// Records the buffers and the Layout (see VertexLayout) applied to the array buffer, leaves the array bound
+	template<class Layout>
+	void setup(glm::uint array_buffer, glm::uint element_buffer = 0, glm::int64 base = 0)
+	{
+		_array_buffer = array_buffer;
+		_element_buffer = element_buffer;
+		_base = base;
+		_apply = &Layout::apply;
+		record();
+	}
+
+	void bind() const;
+
+	// Back to array 0, needed before drawing from client side arrays
+	static void unbind();
+
 	static void enable_attribute_index(glm::uint index);
 
 	static void disable_attribute_index(glm::uint index);
@@ -44,4 +84,12 @@ public:
 	static void draw(Mode const& mode, int first, int count);
 
 	static void draw_elements(Mode const& mode, int count, ElementType const& type, void const* indices);
+
+private:
+	void record();
+
+	glm::uint _array_buffer;
+	glm::uint _element_buffer;
+	glm::int64 _base;
+	void (* _apply)(glm::int64);
 };
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <engine/GLState.hpp>
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+#include "VertexArray.hpp"
+
+/*
+ * Compile time vertex formats, e.g.
+ *
+ *     typedef VertexLayout<Position<glm::vec2>, UV<glm::vec2>, Color<glm::tvec4<std::uint8_t>, true>> SpriteVertex;
+ *     SpriteVertex::apply();
+ *
+ * Stride and offsets are computed by the compiler, and apply() is skipped entirely when the same layout
+ * is already applied to the bound array buffer.
+ */
+namespace vertex
+{
+	template<typename T>
+	struct ComponentType;
+
+	template<> struct ComponentType<float> { static constexpr VertexArray::Type value = VertexArray::Type::Float; };
+	template<> struct ComponentType<std::int8_t> { static constexpr VertexArray::Type value = VertexArray::Type::Byte; };
+	template<> struct ComponentType<std::uint8_t> { static constexpr VertexArray::Type value = VertexArray::Type::UnsignedByte; };
+	template<> struct ComponentType<std::int16_t> { static constexpr VertexArray::Type value = VertexArray::Type::Short; };
+	template<> struct ComponentType<std::uint16_t> { static constexpr VertexArray::Type value = VertexArray::Type::UnsignedShort; };
+
+	template<typename T>
+	struct Format
+	{
+		static constexpr int size = 1;
+		static constexpr VertexArray::Type type = ComponentType<T>::value;
+	};
+
+	template<typename T, glm::precision P>
+	struct Format<glm::tvec2<T, P>>
+	{
+		static constexpr int size = 2;
+		static constexpr VertexArray::Type type = ComponentType<T>::value;
+	};
+
+	template<typename T, glm::precision P>
+	struct Format<glm::tvec3<T, P>>
+	{
+		static constexpr int size = 3;
+		static constexpr VertexArray::Type type = ComponentType<T>::value;
+	};
+
+	template<typename T, glm::precision P>
+	struct Format<glm::tvec4<T, P>>
+	{
+		static constexpr int size = 4;
+		static constexpr VertexArray::Type type = ComponentType<T>::value;
+	};
+
+	template<glm::uint Index, typename T, bool Normalized = false>
+	struct Attribute
+	{
+		typedef T type;
+		static constexpr glm::uint index = Index;
+		static constexpr int size = Format<T>::size;
+		static constexpr VertexArray::Type component = Format<T>::type;
+		static constexpr bool normalized = Normalized;
+		static constexpr int bytes = (int) sizeof(T);
+	};
+
+	template<glm::uint Index, typename... Attributes>
+	struct Offset;
+
+	template<glm::uint Index, typename First, typename... Rest>
+	struct Offset<Index, First, Rest...>
+	{ static constexpr int value = Offset<Index - 1, Rest...>::value + First::bytes; };
+
+	template<typename First, typename... Rest>
+	struct Offset<0, First, Rest...>
+	{ static constexpr int value = 0; };
+
+	template<typename... Attributes>
+	struct Stride;
+
+	template<>
+	struct Stride<>
+	{ static constexpr int value = 0; };
+
+	template<typename First, typename... Rest>
+	struct Stride<First, Rest...>
+	{ static constexpr int value = First::bytes + Stride<Rest...>::value; };
+
+	template<typename... Attributes>
+	struct Mask;
+
+	template<>
+	struct Mask<>
+	{ static constexpr glm::uint value = 0; };
+
+	template<typename First, typename... Rest>
+	struct Mask<First, Rest...>
+	{ static constexpr glm::uint value = (1u << First::index) | Mask<Rest...>::value; };
+}
+
+template<typename T, bool Normalized = false>
+using Position = vertex::Attribute<0, T, Normalized>;
+
+template<typename T, bool Normalized = false>
+using UV = vertex::Attribute<1, T, Normalized>;
+
+template<typename T, bool Normalized = false>
+using Color = vertex::Attribute<2, T, Normalized>;
+
+template<typename T, bool Normalized = false>
+using Normal = vertex::Attribute<3, T, Normalized>;
+
+template<typename... Attributes>
+struct VertexLayout
+{
+	static constexpr int stride = vertex::Stride<Attributes...>::value;
+
+	static constexpr glm::uint mask = vertex::Mask<Attributes...>::value;
+
+	template<glm::uint Index>
+	static constexpr int offset()
+	{ return vertex::Offset<Index, Attributes...>::value; }
+
+	// Applies the layout to the currently bound array buffer, vertices starting at base bytes into it
+	static void apply(glm::int64 base = 0)
+	{
+		if(GLState::layout_current(&tag, base))
+			return;
+
+		GLState::enable_attributes(mask);
+		pointers<0, Attributes...>(base);
+		GLState::layout_applied(&tag, base);
+	}
+
+private:
+	static const char tag;
+
+	template<glm::uint Index>
+	static void pointers(glm::int64)
+	{ }
+
+	template<glm::uint Index, typename First, typename... Rest>
+	static void pointers(glm::int64 base)
+	{
+		VertexArray::attribute_pointer(First::index, First::size, VertexArray::Type{First::component}, First::normalized, stride,
+									   reinterpret_cast<void const*>(static_cast<std::intptr_t>(base + offset<Index>())));
+		pointers<Index + 1, Rest...>(base);
+	}
+};
+
+template<typename... Attributes>
+const char VertexLayout<Attributes...>::tag = 0;
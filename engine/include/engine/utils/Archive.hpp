@@ -0,0 +1,123 @@
+#pragma once
+
+#include <engine/utils/FileSystem.hpp>
+#include <engine/config.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * Packed asset archive, many assets in a single file opened once and mapped in memory.
+ *
+ * Layout : a header, the entry data each aligned on the archive alignment, then a table of contents sorted by
+ * the FNV-1a hash of the entry names and the names themselves. Entries are stored as is, or LZ4 compressed
+ * (block format) when that makes them noticeably smaller. Stored entries can be used in place without any copy.
+ */
+class ENGINE_API Archive final
+{
+public:
+	struct Header
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t count;
+		std::uint32_t alignment;
+		std::uint64_t toc_offset;
+		std::uint64_t names_offset;
+	};
+
+	struct Entry
+	{
+		std::uint64_t hash;
+		std::uint64_t offset;
+		std::uint64_t size; // Size once unpacked
+		std::uint64_t stored_size;
+		std::uint32_t name_offset;
+		std::uint32_t name_length;
+		std::uint32_t flags;
+		std::uint32_t reserved;
+	};
+
+	struct View
+	{
+		unsigned char const* data;
+		size_t size;
+	};
+
+	static const std::uint32_t Version = 1;
+
+	static const std::uint32_t Compressed = 1 << 0;
+
+	explicit Archive(filesystem::Path const& file);
+
+	Archive(Archive const& other) = delete;
+
+	Archive(Archive&& other) = default;
+
+	Archive& operator=(Archive const& other) = delete;
+
+	Archive& operator=(Archive&& other) = default;
+
+	bool contains(std::string const& name) const;
+
+	bool compressed(std::string const& name) const;
+
+	size_t size(std::string const& name) const;
+
+	// Points straight into the mapping, only valid while the archive lives. Null for compressed entries.
+	View view(std::string const& name) const;
+
+	std::vector<unsigned char> read(std::string const& name) const;
+
+	void read(std::string const& name, unsigned char* dst) const;
+
+	std::vector<std::string> names() const;
+
+	inline size_t count() const
+	{ return _count; }
+
+	static std::uint64_t hash(std::string const& name);
+
+	static std::vector<unsigned char> compress(unsigned char const* data, size_t size);
+
+	static bool decompress(unsigned char const* src, size_t size, unsigned char* dst, size_t dst_size);
+
+private:
+	Entry const* find(std::string const& name) const;
+
+	Entry const& get(std::string const& name) const;
+
+	filesystem::MappedFile _file;
+	Entry const* _toc;
+	char const* _names;
+	size_t _count;
+};
+
+class ENGINE_API ArchiveWriter final
+{
+public:
+	explicit ArchiveWriter(filesystem::Path const& file, std::uint32_t alignment = 16);
+
+	~ArchiveWriter();
+
+	ArchiveWriter(ArchiveWriter const& other) = delete;
+
+	ArchiveWriter& operator=(ArchiveWriter const& other) = delete;
+
+	// Compressed entries are only kept compressed when that saves at least an eighth of their size
+	void add(std::string const& name, unsigned char const* data, size_t size, bool compress = false);
+
+	void add_file(std::string const& name, filesystem::Path const& file, bool compress = false);
+
+	void finish();
+
+private:
+	std::ofstream _out;
+	std::uint32_t _alignment;
+	std::uint64_t _offset;
+	std::vector<Archive::Entry> _entries;
+	std::string _names;
+	bool _finished;
+};
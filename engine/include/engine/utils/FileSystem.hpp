@@ -21,6 +21,8 @@
 # include <windows.h>
 #else
 # include <unistd.h>
+# include <sys/mman.h>
+# include <fcntl.h>
 #endif
 
 #if defined(__linux)
@@ -339,4 +341,124 @@ namespace filesystem
 		return mkdir(p.str().c_str(), S_IRUSR | S_IWUSR | S_IXUSR) == 0;
 #endif
 	}
+
+	/*
+	 * Read only view of a whole file mapped in memory, pages are loaded by the kernel on first access
+	 * instead of being copied through read() into a buffer.
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile() : _data(nullptr), _size(0)
+		{ }
+
+		explicit MappedFile(Path const& path) : _data(nullptr), _size(0)
+		{
+#if defined(_WIN32)
+			HANDLE file = CreateFileW(path.wstr().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (file == INVALID_HANDLE_VALUE)
+				throw std::runtime_error("MappedFile: cannot open file \"" + path.str() + "\"!");
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size))
+			{
+				CloseHandle(file);
+				throw std::runtime_error("MappedFile: cannot stat file \"" + path.str() + "\"!");
+			}
+			_size = (size_t) size.QuadPart;
+			if (_size > 0)
+			{
+				HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+				if (mapping != NULL)
+				{
+					_data = static_cast<unsigned char const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+					CloseHandle(mapping);
+				}
+			}
+			CloseHandle(file);
+			if (_size > 0 && _data == nullptr)
+				throw std::runtime_error("MappedFile: cannot map file \"" + path.str() + "\"!");
+#else
+			int fd = ::open(path.str().c_str(), O_RDONLY);
+			if (fd < 0)
+				throw std::runtime_error("MappedFile: cannot open file \"" + path.str() + "\": " + std::string(strerror(errno)));
+			struct stat sb;
+			if (fstat(fd, &sb) != 0)
+			{
+				::close(fd);
+				throw std::runtime_error("MappedFile: cannot stat file \"" + path.str() + "\": " + std::string(strerror(errno)));
+			}
+			_size = (size_t) sb.st_size;
+			if (_size > 0)
+			{
+				void* ptr = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (ptr == MAP_FAILED)
+				{
+					::close(fd);
+					throw std::runtime_error("MappedFile: cannot map file \"" + path.str() + "\": " + std::string(strerror(errno)));
+				}
+				_data = static_cast<unsigned char const*>(ptr);
+			}
+			// The mapping keeps its own reference to the file
+			::close(fd);
+#endif
+		}
+
+		~MappedFile()
+		{ unmap(); }
+
+		MappedFile(MappedFile const&) = delete;
+
+		MappedFile& operator=(MappedFile const&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept : _data(other._data), _size(other._size)
+		{
+			other._data = nullptr;
+			other._size = 0;
+		}
+
+		MappedFile& operator=(MappedFile&& other) noexcept
+		{
+			if (this != &other)
+			{
+				unmap();
+				_data = other._data;
+				_size = other._size;
+				other._data = nullptr;
+				other._size = 0;
+			}
+			return *this;
+		}
+
+		unsigned char const* data() const { return _data; }
+
+		size_t size() const { return _size; }
+
+		bool empty() const { return _size == 0; }
+
+		// Hints the kernel to read the whole file ahead, for files about to be decoded front to back
+		void will_need() const
+		{
+#if !defined(_WIN32)
+			if (_data != nullptr)
+				madvise(const_cast<unsigned char*>(_data), _size, MADV_WILLNEED);
+#endif
+		}
+
+	private:
+		void unmap()
+		{
+			if (_data == nullptr)
+				return;
+#if defined(_WIN32)
+			UnmapViewOfFile(_data);
+#else
+			munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+			_data = nullptr;
+			_size = 0;
+		}
+
+		unsigned char const* _data;
+		size_t _size;
+	};
 }
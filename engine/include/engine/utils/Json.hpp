@@ -36,8 +36,10 @@ SOFTWARE.
 #include <ciso646>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <initializer_list>
 #include <iomanip>
@@ -103,6 +105,233 @@ class DecimalSeparator : public std::numpunct<char>
 
 }
 
+/*!
+@brief monotonic memory for JSON documents
+
+Hands out memory from large blocks and never frees single allocations, the
+blocks are all freed at once when the arena is released or destroyed. Used
+through @ref arena_allocator, which draws from the arena made current on the
+calling thread by a @ref json_arena::scope, so building and discarding a
+document costs a few block allocations instead of one per node.
+
+Values built in an arena must be destroyed before it is released.
+
+@since version 2.0.1-goblin
+*/
+class json_arena
+{
+  public:
+    /// makes an arena the current one of this thread for its lifetime
+    class scope
+    {
+      public:
+        explicit scope(json_arena& arena) noexcept
+            : m_previous(current_slot())
+        {
+            current_slot() = &arena;
+        }
+
+        ~scope()
+        {
+            current_slot() = m_previous;
+        }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+      private:
+        json_arena* m_previous;
+    };
+
+    explicit json_arena(const std::size_t block_size = 64 * 1024) noexcept
+        : m_block_size(block_size)
+    {}
+
+    ~json_arena()
+    {
+        release();
+    }
+
+    json_arena(const json_arena&) = delete;
+    json_arena& operator=(const json_arena&) = delete;
+
+    /// the arena of the innermost scope on this thread, or nullptr
+    static json_arena* current() noexcept
+    {
+        return current_slot();
+    }
+
+    void* allocate(const std::size_t bytes, const std::size_t alignment)
+    {
+        m_allocated += bytes;
+
+        // large requests get their own block so the current one is not wasted
+        if (bytes > m_block_size / 4)
+        {
+            block* b = new_block(bytes + alignment);
+            if (m_blocks != nullptr)
+            {
+                b->next = m_blocks->next;
+                m_blocks->next = b;
+            }
+            else
+            {
+                b->next = nullptr;
+                m_blocks = b;
+                m_cursor = m_limit = b->data();
+            }
+            return align(b->data(), alignment);
+        }
+
+        char* result = align(m_cursor, alignment);
+        if (m_blocks == nullptr or result + bytes > m_limit)
+        {
+            block* b = new_block(m_block_size);
+            b->next = m_blocks;
+            m_blocks = b;
+            m_cursor = b->data();
+            m_limit = m_cursor + m_block_size;
+            result = align(m_cursor, alignment);
+        }
+        m_cursor = result + bytes;
+        return result;
+    }
+
+    /// free every block, all memory handed out becomes invalid
+    void release() noexcept
+    {
+        while (m_blocks != nullptr)
+        {
+            block* next = m_blocks->next;
+            std::free(m_blocks);
+            m_blocks = next;
+        }
+        m_cursor = m_limit = nullptr;
+        m_allocated = m_reserved = 0;
+    }
+
+    /// bytes handed out since the last release
+    std::size_t allocated() const noexcept
+    {
+        return m_allocated;
+    }
+
+    /// bytes taken from the system since the last release
+    std::size_t reserved() const noexcept
+    {
+        return m_reserved;
+    }
+
+  private:
+    struct block
+    {
+        block* next;
+        std::max_align_t pad;
+
+        char* data() noexcept
+        {
+            return reinterpret_cast<char*>(&pad);
+        }
+    };
+
+    static json_arena*& current_slot() noexcept
+    {
+        static thread_local json_arena* arena = nullptr;
+        return arena;
+    }
+
+    static char* align(char* p, const std::size_t alignment) noexcept
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(p);
+        return p + ((alignment - address % alignment) % alignment);
+    }
+
+    block* new_block(const std::size_t size)
+    {
+        void* memory = std::malloc(offsetof(block, pad) + size);
+        if (memory == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        m_reserved += size;
+        return static_cast<block*>(memory);
+    }
+
+    std::size_t m_block_size;
+    block* m_blocks = nullptr;
+    char* m_cursor = nullptr;
+    char* m_limit = nullptr;
+    std::size_t m_allocated = 0;
+    std::size_t m_reserved = 0;
+};
+
+/*!
+@brief allocator drawing from the current @ref json_arena
+
+Stateless so that it can be used as the @a AllocatorType of @ref basic_json,
+which default constructs its allocators. Deallocation does nothing, the
+memory comes back when the arena is released.
+
+@throw std::bad_alloc when no arena is current on the calling thread
+
+@since version 2.0.1-goblin
+*/
+template<typename T>
+class arena_allocator
+{
+  public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind
+    {
+        using other = arena_allocator<U>;
+    };
+
+    arena_allocator() noexcept = default;
+
+    template<typename U>
+    arena_allocator(const arena_allocator<U>&) noexcept
+    {}
+
+    T* allocate(const std::size_t n)
+    {
+        json_arena* arena = json_arena::current();
+        if (arena == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) noexcept
+    {}
+
+    template<typename U, typename... Args>
+    void construct(U* p, Args&& ... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template<typename U>
+    void destroy(U* p)
+    {
+        p->~U();
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const arena_allocator<T>&, const arena_allocator<U>&) noexcept
+{
+    return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const arena_allocator<T>&, const arena_allocator<U>&) noexcept
+{
+    return false;
+}
+
 /*!
 @brief a class to store JSON values
 
@@ -5753,6 +5982,19 @@ class basic_json
         return parser(i, cb).parse();
     }
 
+    /*!
+    @brief deserialize from a buffer
+
+    Parses the buffer in place, it does not need to be null terminated so a
+    memory mapped file can be passed directly.
+
+    @copydetails parse(const string_t&, parser_callback_t)
+    */
+    static basic_json parse(const char* buff, const std::size_t len, parser_callback_t cb = nullptr)
+    {
+        return parser(buff, len, cb).parse();
+    }
+
     /*!
     @brief deserialize from stream
 
@@ -5794,124 +6036,923 @@ class basic_json
 
     /// @}
 
+    //////////////////////////
+    // binary serialization //
+    //////////////////////////
 
-  private:
-    ///////////////////////////
-    // convenience functions //
-    ///////////////////////////
+    /// @name binary serialization
+    /// @{
 
-    /// return the type as string
-    string_t type_name() const noexcept
+    /*!
+    @brief create a CBOR serialization of a given JSON value
+
+    Serializes @a j with the Concise Binary Object Representation (RFC 7049).
+    Integers use the smallest encoding that holds them, floating-point numbers
+    are always stored as double precision so that values survive a round trip.
+
+    @param[in] j  JSON value to serialize
+    @return CBOR serialization as byte vector
+
+    @complexity Linear in the size of @a j.
+
+    @sa @ref from_cbor(const std::vector<uint8_t>&) for the reverse direction
+    */
+    static std::vector<uint8_t> to_cbor(const basic_json& j)
     {
-        switch (m_type)
-        {
-            case value_t::null:
-                return "null";
-            case value_t::object:
-                return "object";
-            case value_t::array:
-                return "array";
-            case value_t::string:
-                return "string";
-            case value_t::boolean:
-                return "boolean";
-            case value_t::discarded:
-                return "discarded";
-            default:
-                return "number";
-        }
+        std::vector<uint8_t> result;
+        to_cbor_internal(j, result);
+        return result;
     }
 
     /*!
-    @brief calculates the extra space to escape a JSON string
+    @brief create a JSON value from a CBOR serialization
 
-    @param[in] s  the string to escape
-    @return the number of characters required to escape string @a s
+    Indefinite-length strings, arrays and maps, tags and half and single
+    precision floats are accepted. Byte strings and simple values other than
+    false, true, null and undefined are not supported.
 
-    @complexity Linear in the length of string @a s.
+    @param[in] v  byte vector with a CBOR serialization
+    @return deserialized JSON value
+
+    @throw std::invalid_argument if the input is not valid CBOR, uses an
+    unsupported type, nests deeper than 512 levels or does not end after the
+    value
+
+    @complexity Linear in the size of @a v.
+
+    @sa @ref to_cbor(const basic_json&) for the reverse direction
     */
-    static std::size_t extra_space(const string_t& s) noexcept
+    static basic_json from_cbor(const std::vector<uint8_t>& v)
     {
-        std::size_t result = 0;
+        return from_cbor(v.data(), v.size());
+    }
 
-        for (const auto& c : s)
-        {
-            switch (c)
-            {
-                case '"':
-                case '\\':
-                case '\b':
-                case '\f':
-                case '\n':
-                case '\r':
-                case '\t':
-                {
-                    // from c (1 byte) to \x (2 bytes)
-                    result += 1;
-                    break;
-                }
+    /*!
+    @copydoc from_cbor(const std::vector<uint8_t>&)
+    @param[in] buff  buffer with a CBOR serialization, e.g. a mapped file
+    @param[in] len   size of the buffer
+    */
+    static basic_json from_cbor(const uint8_t* buff, const std::size_t len)
+    {
+        binary_reader in(buff, len);
+        basic_json result = from_cbor_internal(in);
+        in.expect_end();
+        return result;
+    }
 
-                default:
-                {
-                    if (c >= 0x00 and c <= 0x1f)
-                    {
-                        // from c (1 byte) to \uxxxx (6 bytes)
-                        result += 5;
-                    }
-                    break;
-                }
-            }
-        }
+    /*!
+    @brief create a MessagePack serialization of a given JSON value
+
+    Integers use the smallest encoding that holds them, floating-point numbers
+    are always stored as float 64.
+
+    @param[in] j  JSON value to serialize
+    @return MessagePack serialization as byte vector
+
+    @complexity Linear in the size of @a j.
 
+    @sa @ref from_msgpack(const std::vector<uint8_t>&) for the reverse
+    direction
+    */
+    static std::vector<uint8_t> to_msgpack(const basic_json& j)
+    {
+        std::vector<uint8_t> result;
+        to_msgpack_internal(j, result);
         return result;
     }
 
     /*!
-    @brief escape a string
+    @brief create a JSON value from a MessagePack serialization
 
-    Escape a string by replacing certain special characters by a sequence of
-    an escape character (backslash) and another character and other control
-    characters by a sequence of "\u" followed by a four-digit hex
-    representation.
+    Binary and extension types are not supported.
 
-    @param[in] s  the string to escape
-    @return  the escaped string
+    @param[in] v  byte vector with a MessagePack serialization
+    @return deserialized JSON value
 
-    @complexity Linear in the length of string @a s.
+    @throw std::invalid_argument if the input is not valid MessagePack, uses
+    an unsupported type, nests deeper than 512 levels or does not end after
+    the value
+
+    @complexity Linear in the size of @a v.
+
+    @sa @ref to_msgpack(const basic_json&) for the reverse direction
     */
-    static string_t escape_string(const string_t& s)
+    static basic_json from_msgpack(const std::vector<uint8_t>& v)
     {
-        const auto space = extra_space(s);
-        if (space == 0)
+        return from_msgpack(v.data(), v.size());
+    }
+
+    /*!
+    @copydoc from_msgpack(const std::vector<uint8_t>&)
+    @param[in] buff  buffer with a MessagePack serialization, e.g. a mapped
+    file
+    @param[in] len   size of the buffer
+    */
+    static basic_json from_msgpack(const uint8_t* buff, const std::size_t len)
+    {
+        binary_reader in(buff, len);
+        basic_json result = from_msgpack_internal(in);
+        in.expect_end();
+        return result;
+    }
+
+    /// @}
+
+  private:
+    /// bounds checked big-endian reads from a byte buffer
+    class binary_reader
+    {
+      public:
+        binary_reader(const uint8_t* buff, const std::size_t len) noexcept
+            : m_cursor(buff), m_limit(buff + len)
+        {}
+
+        uint8_t get()
         {
-            return s;
+            require(1);
+            return *m_cursor++;
         }
 
-        // create a result string of necessary size
-        string_t result(s.size() + space, '\\');
-        std::size_t pos = 0;
-
-        for (const auto& c : s)
+        /// read an unsigned big-endian integer of sizeof(T) bytes
+        template<typename T>
+        T get_number()
         {
-            switch (c)
+            require(sizeof(T));
+            T result = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i)
             {
-                // quotation mark (0x22)
-                case '"':
-                {
-                    result[pos + 1] = '"';
-                    pos += 2;
-                    break;
-                }
+                result = static_cast<T>((result << 8) | *m_cursor++);
+            }
+            return result;
+        }
 
-                // reverse solidus (0x5c)
-                case '\\':
-                {
-                    // nothing to change
-                    pos += 2;
-                    break;
-                }
+        float get_float()
+        {
+            const uint32_t bits = get_number<uint32_t>();
+            float result;
+            std::memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
 
-                // backspace (0x08)
+        double get_double()
+        {
+            const uint64_t bits = get_number<uint64_t>();
+            double result;
+            std::memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+
+        string_t get_string(const uint64_t len)
+        {
+            require(len);
+            const auto first = reinterpret_cast<const char*>(m_cursor);
+            m_cursor += len;
+            return string_t(first, static_cast<std::size_t>(len));
+        }
+
+        /// look at the next byte without consuming it
+        uint8_t peek()
+        {
+            require(1);
+            return *m_cursor;
+        }
+
+        void expect_end() const
+        {
+            if (m_cursor != m_limit)
+            {
+                throw std::invalid_argument("parse error - unexpected data after the value");
+            }
+        }
+
+      private:
+        void require(const uint64_t len) const
+        {
+            if (len > static_cast<uint64_t>(m_limit - m_cursor))
+            {
+                throw std::invalid_argument("parse error - unexpected end of input");
+            }
+        }
+
+        const uint8_t* m_cursor;
+        const uint8_t* m_limit;
+    };
+
+    /// append the low @a bytes bytes of @a n in big-endian order
+    static void add_number(std::vector<uint8_t>& v, const uint64_t n, const std::size_t bytes)
+    {
+        for (std::size_t i = bytes; i-- > 0;)
+        {
+            v.push_back(static_cast<uint8_t>((n >> (8 * i)) & 0xff));
+        }
+    }
+
+    static void add_double(std::vector<uint8_t>& v, const double d)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        add_number(v, bits, 8);
+    }
+
+    /// CBOR initial byte for major type @a major followed by its argument
+    static void add_cbor_header(std::vector<uint8_t>& v, const uint8_t major, const uint64_t n)
+    {
+        if (n < 24)
+        {
+            v.push_back(static_cast<uint8_t>(major | n));
+        }
+        else if (n <= 0xff)
+        {
+            v.push_back(static_cast<uint8_t>(major | 24));
+            add_number(v, n, 1);
+        }
+        else if (n <= 0xffff)
+        {
+            v.push_back(static_cast<uint8_t>(major | 25));
+            add_number(v, n, 2);
+        }
+        else if (n <= 0xffffffff)
+        {
+            v.push_back(static_cast<uint8_t>(major | 26));
+            add_number(v, n, 4);
+        }
+        else
+        {
+            v.push_back(static_cast<uint8_t>(major | 27));
+            add_number(v, n, 8);
+        }
+    }
+
+    static void to_cbor_internal(const basic_json& j, std::vector<uint8_t>& v)
+    {
+        switch (j.type())
+        {
+            case value_t::null:
+            case value_t::discarded:
+            {
+                v.push_back(0xf6);
+                break;
+            }
+
+            case value_t::boolean:
+            {
+                v.push_back(j.m_value.boolean ? 0xf5 : 0xf4);
+                break;
+            }
+
+            case value_t::number_integer:
+            {
+                if (j.m_value.number_integer >= 0)
+                {
+                    add_cbor_header(v, 0x00, static_cast<uint64_t>(j.m_value.number_integer));
+                }
+                else
+                {
+                    // major type 1 stores -1 - n
+                    add_cbor_header(v, 0x20, static_cast<uint64_t>(-1 - j.m_value.number_integer));
+                }
+                break;
+            }
+
+            case value_t::number_unsigned:
+            {
+                add_cbor_header(v, 0x00, static_cast<uint64_t>(j.m_value.number_unsigned));
+                break;
+            }
+
+            case value_t::number_float:
+            {
+                v.push_back(0xfb);
+                add_double(v, static_cast<double>(j.m_value.number_float));
+                break;
+            }
+
+            case value_t::string:
+            {
+                add_cbor_header(v, 0x60, j.m_value.string->size());
+                v.insert(v.end(), j.m_value.string->begin(), j.m_value.string->end());
+                break;
+            }
+
+            case value_t::array:
+            {
+                add_cbor_header(v, 0x80, j.m_value.array->size());
+                for (const auto& element : *j.m_value.array)
+                {
+                    to_cbor_internal(element, v);
+                }
+                break;
+            }
+
+            case value_t::object:
+            {
+                add_cbor_header(v, 0xa0, j.m_value.object->size());
+                for (const auto& element : *j.m_value.object)
+                {
+                    add_cbor_header(v, 0x60, element.first.size());
+                    v.insert(v.end(), element.first.begin(), element.first.end());
+                    to_cbor_internal(element.second, v);
+                }
+                break;
+            }
+        }
+    }
+
+    /// argument of a CBOR initial byte, @a indefinite is set for the
+    /// indefinite length marker
+    static uint64_t get_cbor_argument(binary_reader& in, const uint8_t initial, bool& indefinite)
+    {
+        indefinite = false;
+        const uint8_t info = initial & 0x1f;
+        if (info < 24)
+        {
+            return info;
+        }
+
+        switch (info)
+        {
+            case 24:
+                return in.get_number<uint8_t>();
+            case 25:
+                return in.get_number<uint16_t>();
+            case 26:
+                return in.get_number<uint32_t>();
+            case 27:
+                return in.get_number<uint64_t>();
+            case 31:
+                indefinite = true;
+                return 0;
+            default:
+                throw std::invalid_argument("parse error - invalid CBOR additional information");
+        }
+    }
+
+    /// argument of a CBOR initial byte that must have a definite value
+    static uint64_t get_cbor_argument(binary_reader& in, const uint8_t initial)
+    {
+        bool indefinite;
+        const uint64_t n = get_cbor_argument(in, initial, indefinite);
+        if (indefinite)
+        {
+            throw std::invalid_argument("parse error - unexpected CBOR indefinite length");
+        }
+        return n;
+    }
+
+    /// CBOR text string, the initial byte is already consumed
+    static string_t get_cbor_string(binary_reader& in, const uint8_t initial)
+    {
+        bool indefinite;
+        const uint64_t len = get_cbor_argument(in, initial, indefinite);
+        if (not indefinite)
+        {
+            return in.get_string(len);
+        }
+
+        // definite-length chunks until the break byte
+        string_t result;
+        while (in.peek() != 0xff)
+        {
+            const uint8_t chunk = in.get();
+            if ((chunk & 0xe0) != 0x60)
+            {
+                throw std::invalid_argument("parse error - invalid CBOR string chunk");
+            }
+            result += in.get_string(get_cbor_argument(in, chunk));
+        }
+        in.get();
+        return result;
+    }
+
+    /// nesting allowed in the binary formats, deeper input would exhaust the stack
+    static constexpr std::size_t binary_max_depth = 512;
+
+    static basic_json from_cbor_internal(binary_reader& in, const std::size_t depth = 0)
+    {
+        if (depth > binary_max_depth)
+        {
+            throw std::invalid_argument("parse error - CBOR nesting too deep");
+        }
+
+        // a tag only wraps the next item, skip any number of them without recursing
+        uint8_t initial = in.get();
+        while ((initial >> 5) == 6)
+        {
+            get_cbor_argument(in, initial);
+            initial = in.get();
+        }
+
+        switch (initial >> 5)
+        {
+            // unsigned integer
+            case 0:
+            {
+                return basic_json(static_cast<number_unsigned_t>(get_cbor_argument(in, initial)));
+            }
+
+            // negative integer
+            case 1:
+            {
+                const uint64_t n = get_cbor_argument(in, initial);
+                if (n > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+                {
+                    throw std::invalid_argument("parse error - CBOR negative integer out of range");
+                }
+                return basic_json(static_cast<number_integer_t>(-1 - static_cast<int64_t>(n)));
+            }
+
+            // text string
+            case 3:
+            {
+                return basic_json(get_cbor_string(in, initial));
+            }
+
+            // array
+            case 4:
+            {
+                basic_json result(value_t::array);
+                bool indefinite;
+                const uint64_t len = get_cbor_argument(in, initial, indefinite);
+                for (uint64_t i = 0; indefinite or i < len; ++i)
+                {
+                    if (indefinite and in.peek() == 0xff)
+                    {
+                        in.get();
+                        break;
+                    }
+                    result.m_value.array->push_back(from_cbor_internal(in, depth + 1));
+                }
+                return result;
+            }
+
+            // map
+            case 5:
+            {
+                basic_json result(value_t::object);
+                bool indefinite;
+                const uint64_t len = get_cbor_argument(in, initial, indefinite);
+                for (uint64_t i = 0; indefinite or i < len; ++i)
+                {
+                    if (indefinite and in.peek() == 0xff)
+                    {
+                        in.get();
+                        break;
+                    }
+
+                    const uint8_t key = in.get();
+                    if ((key & 0xe0) != 0x60)
+                    {
+                        throw std::invalid_argument("parse error - CBOR map keys must be text strings");
+                    }
+                    string_t k = get_cbor_string(in, key);
+                    (*result.m_value.object)[std::move(k)] = from_cbor_internal(in, depth + 1);
+                }
+                return result;
+            }
+
+            // simple values and floats
+            case 7:
+            {
+                switch (initial)
+                {
+                    case 0xf4:
+                        return basic_json(false);
+                    case 0xf5:
+                        return basic_json(true);
+                    case 0xf6: // null
+                    case 0xf7: // undefined
+                        return basic_json();
+
+                    case 0xf9:
+                    {
+                        // half precision, see RFC 7049 appendix D
+                        const unsigned int half = in.get_number<uint16_t>();
+                        const int exp = (half >> 10) & 0x1f;
+                        const int mant = half & 0x3ff;
+                        double val;
+                        if (exp == 0)
+                        {
+                            val = std::ldexp(mant, -24);
+                        }
+                        else if (exp != 31)
+                        {
+                            val = std::ldexp(mant + 1024, exp - 25);
+                        }
+                        else
+                        {
+                            val = (mant == 0) ? std::numeric_limits<double>::infinity()
+                                  : std::numeric_limits<double>::quiet_NaN();
+                        }
+                        return basic_json(static_cast<number_float_t>((half & 0x8000) ? -val : val));
+                    }
+
+                    case 0xfa:
+                        return basic_json(static_cast<number_float_t>(in.get_float()));
+                    case 0xfb:
+                        return basic_json(static_cast<number_float_t>(in.get_double()));
+
+                    default:
+                        throw std::invalid_argument("parse error - unsupported CBOR simple value");
+                }
+            }
+
+            // byte string
+            default:
+            {
+                throw std::invalid_argument("parse error - CBOR byte strings are not supported");
+            }
+        }
+    }
+
+    /// MessagePack header with a fixed form below @a fix_max, then an 8 bit
+    /// form if @a code8 is set, then 16 and 32 bit forms at @a code16
+    static void add_msgpack_header(std::vector<uint8_t>& v, const uint8_t fix, const uint64_t fix_max,
+                                   const uint8_t code8, const uint8_t code16, const uint64_t n)
+    {
+        if (n < fix_max)
+        {
+            v.push_back(static_cast<uint8_t>(fix | n));
+        }
+        else if (code8 != 0 and n <= 0xff)
+        {
+            v.push_back(code8);
+            add_number(v, n, 1);
+        }
+        else if (n <= 0xffff)
+        {
+            v.push_back(code16);
+            add_number(v, n, 2);
+        }
+        else if (n <= 0xffffffff)
+        {
+            v.push_back(static_cast<uint8_t>(code16 + 1));
+            add_number(v, n, 4);
+        }
+        else
+        {
+            throw std::out_of_range("MessagePack cannot store more than 2^32 - 1 elements");
+        }
+    }
+
+    static void add_msgpack_unsigned(std::vector<uint8_t>& v, const uint64_t n)
+    {
+        if (n < 128)
+        {
+            // positive fixint
+            v.push_back(static_cast<uint8_t>(n));
+        }
+        else if (n <= 0xff)
+        {
+            v.push_back(0xcc);
+            add_number(v, n, 1);
+        }
+        else if (n <= 0xffff)
+        {
+            v.push_back(0xcd);
+            add_number(v, n, 2);
+        }
+        else if (n <= 0xffffffff)
+        {
+            v.push_back(0xce);
+            add_number(v, n, 4);
+        }
+        else
+        {
+            v.push_back(0xcf);
+            add_number(v, n, 8);
+        }
+    }
+
+    static void to_msgpack_internal(const basic_json& j, std::vector<uint8_t>& v)
+    {
+        switch (j.type())
+        {
+            case value_t::null:
+            case value_t::discarded:
+            {
+                v.push_back(0xc0);
+                break;
+            }
+
+            case value_t::boolean:
+            {
+                v.push_back(j.m_value.boolean ? 0xc3 : 0xc2);
+                break;
+            }
+
+            case value_t::number_integer:
+            {
+                const int64_t n = static_cast<int64_t>(j.m_value.number_integer);
+                if (n >= 0)
+                {
+                    add_msgpack_unsigned(v, static_cast<uint64_t>(n));
+                }
+                else if (n >= -32)
+                {
+                    // negative fixint
+                    v.push_back(static_cast<uint8_t>(n));
+                }
+                else if (n >= std::numeric_limits<int8_t>::min())
+                {
+                    v.push_back(0xd0);
+                    add_number(v, static_cast<uint64_t>(n), 1);
+                }
+                else if (n >= std::numeric_limits<int16_t>::min())
+                {
+                    v.push_back(0xd1);
+                    add_number(v, static_cast<uint64_t>(n), 2);
+                }
+                else if (n >= std::numeric_limits<int32_t>::min())
+                {
+                    v.push_back(0xd2);
+                    add_number(v, static_cast<uint64_t>(n), 4);
+                }
+                else
+                {
+                    v.push_back(0xd3);
+                    add_number(v, static_cast<uint64_t>(n), 8);
+                }
+                break;
+            }
+
+            case value_t::number_unsigned:
+            {
+                add_msgpack_unsigned(v, static_cast<uint64_t>(j.m_value.number_unsigned));
+                break;
+            }
+
+            case value_t::number_float:
+            {
+                v.push_back(0xcb);
+                add_double(v, static_cast<double>(j.m_value.number_float));
+                break;
+            }
+
+            case value_t::string:
+            {
+                add_msgpack_header(v, 0xa0, 32, 0xd9, 0xda, j.m_value.string->size());
+                v.insert(v.end(), j.m_value.string->begin(), j.m_value.string->end());
+                break;
+            }
+
+            case value_t::array:
+            {
+                add_msgpack_header(v, 0x90, 16, 0, 0xdc, j.m_value.array->size());
+                for (const auto& element : *j.m_value.array)
+                {
+                    to_msgpack_internal(element, v);
+                }
+                break;
+            }
+
+            case value_t::object:
+            {
+                add_msgpack_header(v, 0x80, 16, 0, 0xde, j.m_value.object->size());
+                for (const auto& element : *j.m_value.object)
+                {
+                    add_msgpack_header(v, 0xa0, 32, 0xd9, 0xda, element.first.size());
+                    v.insert(v.end(), element.first.begin(), element.first.end());
+                    to_msgpack_internal(element.second, v);
+                }
+                break;
+            }
+        }
+    }
+
+    /// MessagePack string, the initial byte is already consumed
+    static string_t get_msgpack_string(binary_reader& in, const uint8_t initial)
+    {
+        if ((initial & 0xe0) == 0xa0)
+        {
+            return in.get_string(initial & 0x1f);
+        }
+        switch (initial)
+        {
+            case 0xd9:
+                return in.get_string(in.get_number<uint8_t>());
+            case 0xda:
+                return in.get_string(in.get_number<uint16_t>());
+            case 0xdb:
+                return in.get_string(in.get_number<uint32_t>());
+            default:
+                throw std::invalid_argument("parse error - MessagePack map keys must be strings");
+        }
+    }
+
+    static basic_json from_msgpack_internal(binary_reader& in, const std::size_t depth = 0)
+    {
+        if (depth > binary_max_depth)
+        {
+            throw std::invalid_argument("parse error - MessagePack nesting too deep");
+        }
+
+        const uint8_t initial = in.get();
+
+        // positive fixint
+        if (initial <= 0x7f)
+        {
+            return basic_json(static_cast<number_unsigned_t>(initial));
+        }
+
+        // negative fixint
+        if (initial >= 0xe0)
+        {
+            return basic_json(static_cast<number_integer_t>(static_cast<int8_t>(initial)));
+        }
+
+        // fixstr
+        if ((initial & 0xe0) == 0xa0)
+        {
+            return basic_json(get_msgpack_string(in, initial));
+        }
+
+        // fixarray, array 16 and array 32
+        if ((initial & 0xf0) == 0x90 or initial == 0xdc or initial == 0xdd)
+        {
+            const uint32_t len = (initial == 0xdc) ? in.get_number<uint16_t>() :
+                                 (initial == 0xdd) ? in.get_number<uint32_t>() : (initial & 0x0fu);
+            basic_json result(value_t::array);
+            for (uint32_t i = 0; i < len; ++i)
+            {
+                result.m_value.array->push_back(from_msgpack_internal(in, depth + 1));
+            }
+            return result;
+        }
+
+        // fixmap, map 16 and map 32
+        if ((initial & 0xf0) == 0x80 or initial == 0xde or initial == 0xdf)
+        {
+            const uint32_t len = (initial == 0xde) ? in.get_number<uint16_t>() :
+                                 (initial == 0xdf) ? in.get_number<uint32_t>() : (initial & 0x0fu);
+            basic_json result(value_t::object);
+            for (uint32_t i = 0; i < len; ++i)
+            {
+                string_t k = get_msgpack_string(in, in.get());
+                (*result.m_value.object)[std::move(k)] = from_msgpack_internal(in, depth + 1);
+            }
+            return result;
+        }
+
+        switch (initial)
+        {
+            case 0xc0:
+                return basic_json();
+            case 0xc2:
+                return basic_json(false);
+            case 0xc3:
+                return basic_json(true);
+
+            case 0xca:
+                return basic_json(static_cast<number_float_t>(in.get_float()));
+            case 0xcb:
+                return basic_json(static_cast<number_float_t>(in.get_double()));
+
+            case 0xcc:
+                return basic_json(static_cast<number_unsigned_t>(in.get_number<uint8_t>()));
+            case 0xcd:
+                return basic_json(static_cast<number_unsigned_t>(in.get_number<uint16_t>()));
+            case 0xce:
+                return basic_json(static_cast<number_unsigned_t>(in.get_number<uint32_t>()));
+            case 0xcf:
+                return basic_json(static_cast<number_unsigned_t>(in.get_number<uint64_t>()));
+
+            case 0xd0:
+                return basic_json(static_cast<number_integer_t>(static_cast<int8_t>(in.get_number<uint8_t>())));
+            case 0xd1:
+                return basic_json(static_cast<number_integer_t>(static_cast<int16_t>(in.get_number<uint16_t>())));
+            case 0xd2:
+                return basic_json(static_cast<number_integer_t>(static_cast<int32_t>(in.get_number<uint32_t>())));
+            case 0xd3:
+                return basic_json(static_cast<number_integer_t>(static_cast<int64_t>(in.get_number<uint64_t>())));
+
+            case 0xd9:
+            case 0xda:
+            case 0xdb:
+                return basic_json(get_msgpack_string(in, initial));
+
+            default:
+                throw std::invalid_argument("parse error - unsupported MessagePack type");
+        }
+    }
+
+
+  private:
+    ///////////////////////////
+    // convenience functions //
+    ///////////////////////////
+
+    /// return the type as string
+    string_t type_name() const noexcept
+    {
+        switch (m_type)
+        {
+            case value_t::null:
+                return "null";
+            case value_t::object:
+                return "object";
+            case value_t::array:
+                return "array";
+            case value_t::string:
+                return "string";
+            case value_t::boolean:
+                return "boolean";
+            case value_t::discarded:
+                return "discarded";
+            default:
+                return "number";
+        }
+    }
+
+    /*!
+    @brief calculates the extra space to escape a JSON string
+
+    @param[in] s  the string to escape
+    @return the number of characters required to escape string @a s
+
+    @complexity Linear in the length of string @a s.
+    */
+    static std::size_t extra_space(const string_t& s) noexcept
+    {
+        std::size_t result = 0;
+
+        for (const auto& c : s)
+        {
+            switch (c)
+            {
+                case '"':
+                case '\\':
+                case '\b':
+                case '\f':
+                case '\n':
+                case '\r':
+                case '\t':
+                {
+                    // from c (1 byte) to \x (2 bytes)
+                    result += 1;
+                    break;
+                }
+
+                default:
+                {
+                    if (c >= 0x00 and c <= 0x1f)
+                    {
+                        // from c (1 byte) to \uxxxx (6 bytes)
+                        result += 5;
+                    }
+                    break;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /*!
+    @brief escape a string
+
+    Escape a string by replacing certain special characters by a sequence of
+    an escape character (backslash) and another character and other control
+    characters by a sequence of "\u" followed by a four-digit hex
+    representation.
+
+    @param[in] s  the string to escape
+    @return  the escaped string
+
+    @complexity Linear in the length of string @a s.
+    */
+    static string_t escape_string(const string_t& s)
+    {
+        const auto space = extra_space(s);
+        if (space == 0)
+        {
+            return s;
+        }
+
+        // create a result string of necessary size
+        string_t result(s.size() + space, '\\');
+        std::size_t pos = 0;
+
+        for (const auto& c : s)
+        {
+            switch (c)
+            {
+                // quotation mark (0x22)
+                case '"':
+                {
+                    result[pos + 1] = '"';
+                    pos += 2;
+                    break;
+                }
+
+                // reverse solidus (0x5c)
+                case '\\':
+                {
+                    // nothing to change
+                    pos += 2;
+                    break;
+                }
+
+                // backspace (0x08)
                 case '\b':
                 {
                     result[pos + 1] = 'b';
@@ -7187,6 +8228,25 @@ class basic_json
             m_limit = m_content + s.size();
         }
 
+        /*!
+        @brief constructor with a given buffer, read in place
+
+        The buffer does not need to be null terminated (e.g. a memory mapped
+        file): once the scanner gets close to its end, the remaining bytes are
+        copied to the internal buffer and scanning goes on from there.
+        */
+        lexer(const char* buff, const std::size_t len) noexcept
+            : m_stream(nullptr), m_buffer(), m_external(true)
+        {
+            m_content = reinterpret_cast<const lexer_char_t*>(buff);
+            m_start = m_cursor = m_content;
+            m_limit = m_content + len;
+            if (len == 0)
+            {
+                yyfill();
+            }
+        }
+
         /// constructor with a given stream
         explicit lexer(std::istream* s) noexcept
             : m_stream(s), m_buffer()
@@ -8103,6 +9163,23 @@ basic_json_parser_63:
         /// append data from the stream to the internal buffer
         void yyfill() noexcept
         {
+            if (m_external)
+            {
+                // move the unscanned tail of an external buffer to the
+                // internal one, which is null terminated
+                m_external = false;
+                const auto offset_marker = m_marker != nullptr ? m_marker - m_start : 0;
+                const auto offset_cursor = m_cursor - m_start;
+                m_buffer.assign(reinterpret_cast<typename string_t::const_pointer>(m_start),
+                                static_cast<size_t>(m_limit - m_start));
+                m_content = reinterpret_cast<const lexer_char_t*>(m_buffer.c_str());
+                m_start  = m_content;
+                m_marker = m_marker != nullptr ? m_start + offset_marker : nullptr;
+                m_cursor = m_start + offset_cursor;
+                m_limit  = m_start + m_buffer.size();
+                return;
+            }
+
             if (m_stream == nullptr or not * m_stream)
             {
                 return;
@@ -8445,6 +9522,8 @@ basic_json_parser_63:
         const lexer_char_t* m_cursor = nullptr;
         /// pointer to the end of the buffer
         const lexer_char_t* m_limit = nullptr;
+        /// whether m_content still points to a caller buffer
+        bool m_external = false;
     };
 
     /*!
@@ -8463,6 +9542,14 @@ basic_json_parser_63:
             get_token();
         }
 
+        /// a parser reading a buffer in place
+        parser(const char* buff, const std::size_t len, parser_callback_t cb = nullptr) noexcept
+            : callback(cb), m_lexer(buff, len)
+        {
+            // read first token
+            get_token();
+        }
+
         /// a parser reading from an input stream
         parser(std::istream& _is, parser_callback_t cb = nullptr) noexcept
             : callback(cb), m_lexer(&_is)
@@ -8496,8 +9583,9 @@ basic_json_parser_63:
                     if (keep and (not callback or (keep = callback(depth++, parse_event_t::object_start, result))))
                     {
                         // explicitly set result to object to cope with {}
-                        result.m_type = value_t::object;
+                        // value first, so a failed allocation leaves result discarded
                         result.m_value = json_value(value_t::object);
+                        result.m_type = value_t::object;
                     }
 
                     // read next token
@@ -8574,8 +9662,9 @@ basic_json_parser_63:
                     if (keep and (not callback or (keep = callback(depth++, parse_event_t::array_start, result))))
                     {
                         // explicitly set result to object to cope with []
-                        result.m_type = value_t::array;
+                        // value first, so a failed allocation leaves result discarded
                         result.m_value = json_value(value_t::array);
+                        result.m_type = value_t::array;
                     }
 
                     // read next token
@@ -8717,6 +9806,388 @@ basic_json_parser_63:
         lexer m_lexer;
     };
 
+  public:
+    /*!
+    @brief pull reader
+
+    Reads a JSON text one event at a time without building a DOM, so large
+    inputs can be processed with memory bounded by the nesting depth. Values
+    are reported by the event returned from @ref next and read with the
+    accessors; strings and keys are in @ref get_string.
+
+    The string and buffer passed to the constructors must outlive the reader.
+
+    @throw std::invalid_argument from @ref next in case of parse errors
+    */
+    class reader
+    {
+      public:
+        /// events reported by next()
+        enum class event
+        {
+            null,            ///< a `null` value
+            boolean,         ///< a boolean -- use get_boolean()
+            number_integer,  ///< a negative integer -- use get_integer()
+            number_unsigned, ///< a positive integer -- use get_unsigned()
+            number_float,    ///< a floating-point number -- use get_float()
+            string,          ///< a string value -- use get_string()
+            key,             ///< an object key -- use get_string()
+            start_object,    ///< an object begins
+            end_object,      ///< the current object ends
+            start_array,     ///< an array begins
+            end_array,       ///< the current array ends
+            end_of_input     ///< the top-level value is complete
+        };
+
+        /// reader for a string
+        explicit reader(const string_t& s)
+            : m_lexer(s)
+        {
+            get_token();
+        }
+
+        /// reader for an input stream
+        explicit reader(std::istream& i)
+            : m_lexer(&i)
+        {
+            get_token();
+        }
+
+        /// reader for a buffer, which does not need to be null terminated
+        reader(const char* buff, const std::size_t len)
+            : m_lexer(buff, len)
+        {
+            get_token();
+        }
+
+        reader(const reader&) = delete;
+        reader operator=(const reader&) = delete;
+
+        /// read the next event
+        event next()
+        {
+            if (m_done)
+            {
+                return event::end_of_input;
+            }
+
+            if (m_stack.empty())
+            {
+                if (m_started)
+                {
+                    expect(lexer::token_type::end_of_input);
+                    m_done = true;
+                    return event::end_of_input;
+                }
+                m_started = true;
+            }
+            else if (not m_after_key)
+            {
+                const bool object = m_stack.back();
+
+                // closing bracket, either the container is empty or a value
+                // was just read
+                if (m_token == (object ? lexer::token_type::end_object : lexer::token_type::end_array))
+                {
+                    m_stack.pop_back();
+                    m_first = false;
+                    get_token();
+                    return object ? event::end_object : event::end_array;
+                }
+
+                if (not m_first)
+                {
+                    expect(lexer::token_type::value_separator);
+                    get_token();
+                }
+                m_first = false;
+
+                if (object)
+                {
+                    expect(lexer::token_type::value_string);
+                    m_string = m_lexer.get_string();
+                    get_token();
+                    expect(lexer::token_type::name_separator);
+                    get_token();
+                    m_after_key = true;
+                    return event::key;
+                }
+            }
+
+            m_after_key = false;
+            switch (m_token)
+            {
+                case lexer::token_type::begin_object:
+                {
+                    m_stack.push_back(true);
+                    m_first = true;
+                    get_token();
+                    return event::start_object;
+                }
+
+                case lexer::token_type::begin_array:
+                {
+                    m_stack.push_back(false);
+                    m_first = true;
+                    get_token();
+                    return event::start_array;
+                }
+
+                case lexer::token_type::literal_null:
+                {
+                    m_value = nullptr;
+                    get_token();
+                    return event::null;
+                }
+
+                case lexer::token_type::literal_true:
+                case lexer::token_type::literal_false:
+                {
+                    m_value = (m_token == lexer::token_type::literal_true);
+                    get_token();
+                    return event::boolean;
+                }
+
+                case lexer::token_type::value_string:
+                {
+                    m_string = m_lexer.get_string();
+                    get_token();
+                    return event::string;
+                }
+
+                case lexer::token_type::value_number:
+                {
+                    m_lexer.get_number(m_value);
+                    get_token();
+                    switch (m_value.m_type)
+                    {
+                        case value_t::number_integer:
+                            return event::number_integer;
+                        case value_t::number_unsigned:
+                            return event::number_unsigned;
+                        default:
+                            return event::number_float;
+                    }
+                }
+
+                default:
+                {
+                    unexpect(m_token);
+                    return event::end_of_input;
+                }
+            }
+        }
+
+        /*!
+        @brief skip the rest of the current container
+
+        To be called right after start_object or start_array; the next event
+        is the one following the matching end_object or end_array.
+        */
+        void skip()
+        {
+            const auto d = depth();
+            while (depth() >= d and next() != event::end_of_input)
+            {
+            }
+        }
+
+        /// nesting depth of the current position
+        std::size_t depth() const noexcept
+        {
+            return m_stack.size();
+        }
+
+        /// value of a string or key event
+        const string_t& get_string() const noexcept
+        {
+            return m_string;
+        }
+
+        /// value of a boolean event
+        boolean_t get_boolean() const noexcept
+        {
+            return m_value.m_value.boolean;
+        }
+
+        /// value of a number_integer event
+        number_integer_t get_integer() const noexcept
+        {
+            return m_value.m_value.number_integer;
+        }
+
+        /// value of a number_unsigned event
+        number_unsigned_t get_unsigned() const noexcept
+        {
+            return m_value.m_value.number_unsigned;
+        }
+
+        /// value of a number event of any kind
+        number_float_t get_float() const noexcept
+        {
+            switch (m_value.m_type)
+            {
+                case value_t::number_integer:
+                    return static_cast<number_float_t>(m_value.m_value.number_integer);
+                case value_t::number_unsigned:
+                    return static_cast<number_float_t>(m_value.m_value.number_unsigned);
+                default:
+                    return m_value.m_value.number_float;
+            }
+        }
+
+      private:
+        void get_token() noexcept
+        {
+            m_token = m_lexer.scan();
+        }
+
+        void expect(typename lexer::token_type t) const
+        {
+            if (t != m_token)
+            {
+                std::string error_msg = "parse error - unexpected ";
+                error_msg += (m_token == lexer::token_type::parse_error ? ("'" +  m_lexer.get_token() + "'") :
+                              lexer::token_type_name(m_token));
+                error_msg += "; expected " + lexer::token_type_name(t);
+                throw std::invalid_argument(error_msg);
+            }
+        }
+
+        void unexpect(typename lexer::token_type t) const
+        {
+            if (t == m_token)
+            {
+                std::string error_msg = "parse error - unexpected ";
+                error_msg += (m_token == lexer::token_type::parse_error ? ("'" +  m_lexer.get_token() + "'") :
+                              lexer::token_type_name(m_token));
+                throw std::invalid_argument(error_msg);
+            }
+        }
+
+        /// the lexer
+        lexer m_lexer;
+        /// the current token, not consumed yet
+        typename lexer::token_type m_token = lexer::token_type::uninitialized;
+        /// open containers, true for objects
+        std::vector<bool> m_stack;
+        /// whether the current container has no value yet
+        bool m_first = false;
+        /// whether a key was just read and its value is next
+        bool m_after_key = false;
+        /// whether the top-level value was started
+        bool m_started = false;
+        /// whether the end of input was reached
+        bool m_done = false;
+        /// last string or key
+        string_t m_string;
+        /// last scalar value (never a string)
+        basic_json m_value;
+    };
+
+    /*!
+    @brief SAX interface
+
+    Receives the events of @ref sax_parse. Returning false from any function
+    stops parsing.
+    */
+    class sax_handler
+    {
+      public:
+        virtual ~sax_handler() = default;
+
+        virtual bool null() = 0;
+        virtual bool boolean(boolean_t val) = 0;
+        virtual bool number_integer(number_integer_t val) = 0;
+        virtual bool number_unsigned(number_unsigned_t val) = 0;
+        virtual bool number_float(number_float_t val) = 0;
+        virtual bool string(string_t& val) = 0;
+        virtual bool key(string_t& val) = 0;
+        virtual bool start_object() = 0;
+        virtual bool end_object() = 0;
+        virtual bool start_array() = 0;
+        virtual bool end_array() = 0;
+    };
+
+    /*!
+    @brief run a SAX handler over a reader
+
+    @return whether the whole input was read, false if the handler stopped
+
+    @throw std::invalid_argument in case of parse errors
+    */
+    static bool sax_parse(reader& r, sax_handler& sax)
+    {
+        while (true)
+        {
+            bool keep_going = true;
+            switch (r.next())
+            {
+                case reader::event::null:
+                    keep_going = sax.null();
+                    break;
+                case reader::event::boolean:
+                    keep_going = sax.boolean(r.get_boolean());
+                    break;
+                case reader::event::number_integer:
+                    keep_going = sax.number_integer(r.get_integer());
+                    break;
+                case reader::event::number_unsigned:
+                    keep_going = sax.number_unsigned(r.get_unsigned());
+                    break;
+                case reader::event::number_float:
+                    keep_going = sax.number_float(r.get_float());
+                    break;
+                case reader::event::string:
+                    keep_going = sax.string(const_cast<string_t&>(r.get_string()));
+                    break;
+                case reader::event::key:
+                    keep_going = sax.key(const_cast<string_t&>(r.get_string()));
+                    break;
+                case reader::event::start_object:
+                    keep_going = sax.start_object();
+                    break;
+                case reader::event::end_object:
+                    keep_going = sax.end_object();
+                    break;
+                case reader::event::start_array:
+                    keep_going = sax.start_array();
+                    break;
+                case reader::event::end_array:
+                    keep_going = sax.end_array();
+                    break;
+                case reader::event::end_of_input:
+                    return true;
+            }
+
+            if (not keep_going)
+            {
+                return false;
+            }
+        }
+    }
+
+    /// @copydoc sax_parse(reader&, sax_handler&)
+    static bool sax_parse(const string_t& s, sax_handler& sax)
+    {
+        reader r(s);
+        return sax_parse(r, sax);
+    }
+
+    /// @copydoc sax_parse(reader&, sax_handler&)
+    static bool sax_parse(std::istream& i, sax_handler& sax)
+    {
+        reader r(i);
+        return sax_parse(r, sax);
+    }
+
+    /// @copydoc sax_parse(reader&, sax_handler&)
+    static bool sax_parse(const char* buff, const std::size_t len, sax_handler& sax)
+    {
+        reader r(buff, len);
+        return sax_parse(r, sax);
+    }
+
   public:
     /*!
     @brief JSON Pointer
@@ -9958,6 +11429,32 @@ uses the standard template types.
 @since version 1.0.0
 */
 using json = basic_json<>;
+
+/*!
+@brief JSON class with its nodes in the current @ref json_arena
+
+Objects, arrays and their elements come from the arena; strings stay
+`std::string`, so only characters past the small string buffer still go
+through the heap.
+
+For parse-and-discard workloads, e.g.
+
+@code
+json_arena arena;
+{
+    json_arena::scope scope(arena);
+    arena_json config = arena_json::parse(text);
+    // ...
+}
+@endcode
+
+Values must be created, copied, modified and destroyed while the arena is
+current, and destroyed before it is released.
+
+@since version 2.0.1-goblin
+*/
+using arena_json = basic_json<std::map, std::vector, std::string, bool,
+      std::int64_t, std::uint64_t, double, arena_allocator>;
 }
 
 
@@ -4090,6 +4090,10 @@ namespace sol {
 		inline std::string get_type_name(const std::type_info& id) {
 			int status;
 			char* unmangled = abi::__cxa_demangle(id.name(), 0, 0, &status);
+			if (unmangled == nullptr) {
+				// Demangling fails on very long names, e.g. usertypes bound with many lambdas
+				return id.name();
+			}
 			std::string realname = unmangled;
 			std::free(unmangled);
 			return realname;
@@ -4098,6 +4102,10 @@ namespace sol {
 		inline std::string get_type_name(const std::type_info& id) {
 			int status;
 			char* unmangled = abi::__cxa_demangle(id.name(), 0, 0, &status);
+			if (unmangled == nullptr) {
+				// Demangling fails on very long names, e.g. usertypes bound with many lambdas
+				return id.name();
+			}
 			std::string realname = unmangled;
 			std::free(unmangled);
 			return realname;
@@ -0,0 +1,268 @@
+#include <engine/AsyncIO.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+
+using namespace std;
+
+namespace
+{
+	// Cancellation is checked between chunks, small enough to stop quickly and large enough to stay sequential
+	const size_t ChunkSize = 256 * 1024;
+}
+
+AsyncIO::AsyncIO(unsigned workers) : _next(Invalid), _stop(false)
+{
+	for(unsigned i = 0; i < max(workers, 1u); ++i)
+		_workers.emplace_back(&AsyncIO::worker_loop, this);
+}
+
+AsyncIO::~AsyncIO()
+{
+	cancel_all();
+	{
+		lock_guard<mutex> lock{_mutex};
+		_stop = true;
+	}
+	_wake.notify_all();
+	for(auto& t : _workers)
+		t.join();
+}
+
+AsyncIO::Request AsyncIO::read(filesystem::Path const& file, Completion done, Priority priority)
+{
+	unique_ptr<Job> job{new Job};
+	job->kind = Kind::Read;
+	job->path = file;
+	job->dst = nullptr;
+	job->size = 0;
+	job->offset = 0;
+	job->done = move(done);
+	job->priority = priority;
+	return submit(move(job));
+}
+
+AsyncIO::Request AsyncIO::read(filesystem::Path const& file, unsigned char* dst, size_t size, size_t offset, Completion done, Priority priority)
+{
+	unique_ptr<Job> job{new Job};
+	job->kind = Kind::ReadInto;
+	job->path = file;
+	job->dst = dst;
+	job->size = size;
+	job->offset = offset;
+	job->done = move(done);
+	job->priority = priority;
+	return submit(move(job));
+}
+
+AsyncIO::Request AsyncIO::write(filesystem::Path const& file, vector<unsigned char> data, Completion done, Priority priority)
+{
+	unique_ptr<Job> job{new Job};
+	job->kind = Kind::Write;
+	job->path = file;
+	job->dst = nullptr;
+	job->size = data.size();
+	job->offset = 0;
+	job->data = move(data);
+	job->done = move(done);
+	job->priority = priority;
+	return submit(move(job));
+}
+
+AsyncIO::Request AsyncIO::submit(unique_ptr<Job> job)
+{
+	job->cancelled = false;
+	job->running = false;
+	job->status = Status::Done;
+	job->transferred = 0;
+
+	shared_ptr<Job> shared{move(job)};
+	{
+		lock_guard<mutex> lock{_mutex};
+		shared->id = ++_next;
+		if(shared->id == Invalid)
+			shared->id = ++_next;
+
+		// Highest priority first, then in request order
+		_queue[Key{-static_cast<int>(shared->priority), shared->id}] = shared;
+		_jobs[shared->id] = shared;
+	}
+	_wake.notify_one();
+	return shared->id;
+}
+
+bool AsyncIO::cancel(Request request)
+{
+	lock_guard<mutex> lock{_mutex};
+	auto it = _jobs.find(request);
+	if(it == _jobs.end() || find(_done.begin(), _done.end(), it->second) != _done.end())
+		return false;
+
+	auto job = it->second;
+	job->cancelled = true;
+	if(!job->running)
+	{
+		_queue.erase(Key{-static_cast<int>(job->priority), job->id});
+		job->status = Status::Cancelled;
+		_done.push_back(job);
+	}
+	return true;
+}
+
+void AsyncIO::cancel_all()
+{
+	vector<Request> requests;
+	{
+		lock_guard<mutex> lock{_mutex};
+		for(auto const& j : _jobs)
+			requests.push_back(j.first);
+	}
+	for(auto r : requests)
+		cancel(r);
+}
+
+void AsyncIO::dispatch()
+{
+	vector<shared_ptr<Job>> done;
+	{
+		lock_guard<mutex> lock{_mutex};
+		if(_done.empty())
+			return;
+		done.swap(_done);
+		for(auto const& job : done)
+			_jobs.erase(job->id);
+	}
+
+	for(auto const& job : done)
+	{
+		if(!job->done)
+			continue;
+		Result result{job->id, job->status, job->path, {}, job->transferred, job->error};
+		if(job->kind == Kind::Read)
+			result.data = move(job->data);
+		job->done(result);
+	}
+}
+
+void AsyncIO::notify(function<void()> callback)
+{
+	lock_guard<mutex> lock{_mutex};
+	_notify = move(callback);
+}
+
+size_t AsyncIO::pending() const
+{
+	lock_guard<mutex> lock{_mutex};
+	return _jobs.size();
+}
+
+void AsyncIO::worker_loop()
+{
+	while(true)
+	{
+		shared_ptr<Job> job;
+		{
+			unique_lock<mutex> lock{_mutex};
+			_wake.wait(lock, [this] { return _stop || !_queue.empty(); });
+			if(_stop)
+				return;
+			job = _queue.begin()->second;
+			_queue.erase(_queue.begin());
+			job->running = true;
+		}
+
+		try
+		{
+			run(*job);
+		}
+		catch(exception const& e)
+		{
+			job->status = Status::Failed;
+			job->error = e.what();
+		}
+		if(job->cancelled)
+			job->status = Status::Cancelled;
+
+		function<void()> notify;
+		{
+			lock_guard<mutex> lock{_mutex};
+			_done.push_back(job);
+			notify = _notify;
+		}
+		if(notify)
+			notify();
+	}
+}
+
+void AsyncIO::run(Job& job)
+{
+	if(job.kind == Kind::Write)
+	{
+		string tmp = job.path.str() + ".tmp";
+		{
+			ofstream out{tmp, ios::binary | ios::trunc};
+			for(size_t pos = 0; out && pos < job.data.size() && !job.cancelled; pos += ChunkSize)
+			{
+				size_t len = min(ChunkSize, job.data.size() - pos);
+				out.write(reinterpret_cast<char const*>(job.data.data() + pos), (streamsize) len);
+				job.transferred += len;
+			}
+			out.flush();
+			if(!out)
+			{
+				job.status = Status::Failed;
+				job.error = "Could not write '" + tmp + "'";
+			}
+		}
+
+		if(job.cancelled || job.status == Status::Failed || rename(tmp.c_str(), job.path.str().c_str()) != 0)
+		{
+			remove(tmp.c_str());
+			if(!job.cancelled && job.status != Status::Failed)
+			{
+				job.status = Status::Failed;
+				job.error = "Could not replace '" + job.path.str() + "'";
+			}
+		}
+		return;
+	}
+
+	ifstream in{job.path.str(), ios::binary};
+	if(!in)
+	{
+		job.status = Status::Failed;
+		job.error = "Could not open '" + job.path.str() + "'";
+		return;
+	}
+
+	unsigned char* dst = job.dst;
+	size_t size = job.size;
+	if(job.kind == Kind::Read)
+	{
+		in.seekg(0, ios::end);
+		size = (size_t) in.tellg();
+		in.seekg(0, ios::beg);
+		job.data.resize(size);
+		dst = job.data.data();
+	}
+	else if(job.offset > 0)
+	{
+		in.seekg((streamoff) job.offset);
+	}
+
+	while(job.transferred < size && !job.cancelled)
+	{
+		in.read(reinterpret_cast<char*>(dst + job.transferred), (streamsize) min(ChunkSize, size - job.transferred));
+		job.transferred += (size_t) in.gcount();
+		if(!in)
+			break;
+	}
+
+	// Short reads into a caller buffer are fine, the result tells how much was read
+	if(job.kind == Kind::Read && job.transferred != size && !job.cancelled)
+	{
+		job.status = Status::Failed;
+		job.error = "Could not read '" + job.path.str() + "'";
+	}
+}
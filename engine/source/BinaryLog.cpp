@@ -0,0 +1,166 @@
+#include <engine/BinaryLog.hpp>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+	// Same back off as spdlog's async helper, spin first then yield and finally sleep
+	void sleep_or_yield(spdlog::log_clock::time_point const& now, spdlog::log_clock::time_point const& last_op)
+	{
+		auto since = now - last_op;
+		if(since <= chrono::microseconds(50))
+			return;
+		if(since <= chrono::microseconds(100))
+			return this_thread::yield();
+		if(since <= chrono::milliseconds(200))
+			return this_thread::sleep_for(chrono::milliseconds(20));
+		this_thread::sleep_for(chrono::milliseconds(200));
+	}
+}
+
+BinaryLog::BinaryLog(string const& name, vector<spdlog::sink_ptr> const& sinks, size_t queue_size,
+					 spdlog::async_overflow_policy overflow, chrono::milliseconds flush_interval) :
+		_name(name), _sinks(sinks), _formatter(make_shared<spdlog::pattern_formatter>("%+")), _q(queue_size),
+		_overflow(overflow), _flush_interval(flush_interval), _dropped(0), _worker(&BinaryLog::worker_loop, this)
+{ }
+
+BinaryLog::~BinaryLog()
+{
+	Record r;
+	r.kind = Kind::Terminate;
+	push(move(r));
+	_worker.join();
+}
+
+void BinaryLog::flush()
+{
+	Record r;
+	r.kind = Kind::Flush;
+	push(move(r));
+}
+
+void BinaryLog::store_text(Record& r, char const* text, size_t size)
+{
+	char* dst = reinterpret_cast<char*>(r.payload);
+	if(size < PayloadSize)
+	{
+		r.kind = Kind::Text;
+	}
+	else
+	{
+		// Rare long messages, the worker frees the copy once written
+		r.kind = Kind::OwnedText;
+		char* owned = new char[size + 1];
+		memcpy(r.payload, &owned, sizeof(owned));
+		dst = owned;
+	}
+	memcpy(dst, text, size);
+	dst[size] = '\0';
+}
+
+void BinaryLog::push(Record&& r)
+{
+	if(_q.enqueue(move(r)))
+		return;
+
+	bool control = r.kind == Kind::Flush || r.kind == Kind::Terminate;
+	if(_overflow == spdlog::async_overflow_policy::discard_log_msg && !control)
+	{
+		if(r.kind == Kind::OwnedText)
+		{
+			char* owned;
+			memcpy(&owned, r.payload, sizeof(owned));
+			delete[] owned;
+		}
+		_dropped.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+
+	auto last_op = spdlog::details::os::now();
+	do
+		sleep_or_yield(spdlog::details::os::now(), last_op);
+	while(!_q.enqueue(move(r)));
+}
+
+void BinaryLog::write(Record const& r)
+{
+	spdlog::details::log_msg msg;
+	msg.logger_name = &_name;
+	msg.level = r.level;
+	msg.time = r.time;
+	msg.thread_id = r.thread_id;
+
+	if(r.kind == Kind::Packed)
+	{
+		try
+		{
+			r.format(r, msg.raw);
+		}
+		catch(fmt::FormatError& ex)
+		{
+			msg.raw.clear();
+			msg.raw << "format error in \"" << r.fmt << "\": " << ex.what();
+		}
+	}
+	else if(r.kind == Kind::Text)
+	{
+		msg.raw << reinterpret_cast<char const*>(r.payload);
+	}
+	else
+	{
+		char* owned;
+		memcpy(&owned, r.payload, sizeof(owned));
+		msg.raw << owned;
+		delete[] owned;
+	}
+
+	_formatter->format(msg);
+	for(auto& s : _sinks)
+		s->log(msg);
+}
+
+void BinaryLog::worker_loop()
+{
+	auto last_pop = spdlog::details::os::now();
+	auto last_flush = last_pop;
+	bool flush_requested = false;
+	bool terminate = false;
+
+	while(true)
+	{
+		Record r;
+		if(_q.dequeue(r))
+		{
+			last_pop = spdlog::details::os::now();
+			if(r.kind == Kind::Terminate)
+				flush_requested = terminate = true;
+			else if(r.kind == Kind::Flush)
+				flush_requested = true;
+			else
+			{
+				// A failing sink has nowhere to report to, keep the worker alive for the others
+				try
+				{ write(r); }
+				catch(exception const&)
+				{ }
+			}
+			continue;
+		}
+
+		// Only flush when the queue is empty, a burst of messages is written in one go
+		auto now = spdlog::details::os::now();
+		if(flush_requested || (_flush_interval != chrono::milliseconds::zero() && now - last_flush >= _flush_interval))
+		{
+			for(auto& s : _sinks)
+				s->flush();
+			now = last_flush = spdlog::details::os::now();
+			flush_requested = false;
+		}
+
+		if(terminate)
+			break;
+		sleep_or_yield(now, last_pop);
+	}
+}
@@ -0,0 +1,307 @@
+#include <engine/DynamicResolution.hpp>
+#include <engine/GLState.hpp>
+#include <engine/Engine.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace glm;
+
+namespace
+{
+	const char* UpscaleVertex = R"(
+attribute vec2 a_position;
+uniform vec2 u_scale;
+varying vec2 v_uv;
+void main()
+{
+	v_uv = (a_position * 0.5 + 0.5) * u_scale;
+	gl_Position = vec4(a_position, 0.0, 1.0);
+}
+)";
+
+	// Texture coordinates need more than mediump on a 1080p target
+	const char* UpscaleFragment = R"(
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+uniform sampler2D u_source;
+uniform vec2 u_clamp;
+varying vec2 v_uv;
+void main()
+{
+	gl_FragColor = texture2D(u_source, min(v_uv, u_clamp));
+}
+)";
+
+	// One triangle covering the screen, no diagonal seam and no buffer needed
+	const GLfloat Triangle[6]{-1.f, -1.f, 3.f, -1.f, -1.f, 3.f};
+
+	const GLenum SavedCaps[5]{GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND, GL_STENCIL_TEST, GL_SCISSOR_TEST};
+
+	// Frames left alone after a change so the measurements reflect the new scale
+	const int Cooldown = 8;
+
+	// Frames on time in a row before trying a larger scale without GPU timing
+	const int ProbeFrames = 180;
+
+	inline double seconds(Duration d)
+	{ return chrono::duration<double>(d).count(); }
+}
+
+DynamicResolution::DynamicResolution() :
+		_enabled(false), _min_scale(0.5f), _scale(1.f), _display(0), _size(0), _framebuffer(0), _color(0), _depth(0), _stencil(0),
+		_source_location(-1), _scale_location(-1), _clamp_location(-1), _queries{}, _query_next(0), _query_pending(0), _gpu_time(0.0),
+		_cooldown(0), _on_time(0)
+{ }
+
+DynamicResolution::~DynamicResolution()
+{
+	release();
+}
+
+void DynamicResolution::enable(bool enabled)
+{
+	if(enabled == _enabled)
+		return;
+
+	if(!enabled)
+	{
+		release();
+		_enabled = false;
+		return;
+	}
+
+	try
+	{
+		_program.build(UpscaleVertex, UpscaleFragment, {{0, "a_position"}});
+	}
+	catch(exception const& e)
+	{
+		ERR("DynamicResolution::enable => {}", e.what());
+		return;
+	}
+	_source_location = _program.uniform_location("u_source");
+	_scale_location = _program.uniform_location("u_scale");
+	_clamp_location = _program.uniform_location("u_clamp");
+
+	if(GLAD_GL_EXT_disjoint_timer_query)
+		glGenQueriesEXT(Queries, _queries);
+
+	_enabled = true;
+	_scale = 1.f;
+	_cooldown = Cooldown;
+	DEBUG("DynamicResolution::enable => Enabled, {} timing", gpu_timing() ? "GPU" : "present");
+}
+
+void DynamicResolution::min_scale(float scale)
+{
+	_min_scale = clamp(scale, 0.1f, 1.f);
+	_scale = std::max(_scale, _min_scale);
+}
+
+void DynamicResolution::allocate(ivec2 const& size)
+{
+	if(_framebuffer == 0)
+		glGenFramebuffers(1, &_framebuffer);
+	if(_color == 0)
+		glGenTextures(1, &_color);
+
+	GLState::active_texture(GL_TEXTURE0);
+	GLState::bind_texture(GL_TEXTURE_2D, _color);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	// Painter fills through the stencil buffer, the target needs one as much as the backbuffer does
+	if(_depth == 0)
+		glGenRenderbuffers(1, &_depth);
+	glBindRenderbuffer(GL_RENDERBUFFER, _depth);
+	glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _color, 0);
+	if(GLAD_GL_OES_packed_depth_stencil)
+	{
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8_OES, size.x, size.y);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depth);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _depth);
+	}
+	else
+	{
+		if(_stencil == 0)
+			glGenRenderbuffers(1, &_stencil);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, size.x, size.y);
+		glBindRenderbuffer(GL_RENDERBUFFER, _stencil);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_STENCIL_INDEX8, size.x, size.y);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depth);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _stencil);
+	}
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	if(status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		ERR("DynamicResolution::allocate => Incomplete framebuffer (0x{:x}), rendering at native resolution", status);
+		release();
+		_enabled = false;
+		return;
+	}
+
+	_display = size;
+	DEBUG("DynamicResolution::allocate => Target of {}x{}", size.x, size.y);
+}
+
+void DynamicResolution::release()
+{
+	if(_queries[0] != 0)
+	{
+		glDeleteQueriesEXT(Queries, _queries);
+		fill(begin(_queries), end(_queries), 0u);
+	}
+	_query_next = _query_pending = 0;
+
+	if(_framebuffer != 0)
+		glDeleteFramebuffers(1, &_framebuffer);
+	if(_color != 0)
+		GLState::delete_textures(1, &_color);
+	if(_depth != 0)
+		glDeleteRenderbuffers(1, &_depth);
+	if(_stencil != 0)
+		glDeleteRenderbuffers(1, &_stencil);
+	_framebuffer = _color = _depth = _stencil = 0;
+	_display = _size = ivec2(0);
+	_program.destroy();
+}
+
+void DynamicResolution::begin_scene(ivec2 const& display_size)
+{
+	if(!_enabled)
+		return;
+	if(display_size != _display)
+	{
+		allocate(display_size);
+		if(!_enabled)
+			return;
+	}
+
+	_size = max(ivec2(round(vec2(_display) * _scale)), ivec2(1));
+	glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+	glViewport(0, 0, _size.x, _size.y);
+
+	if(gpu_timing() && _query_pending < Queries)
+		glBeginQueryEXT(GL_TIME_ELAPSED_EXT, _queries[_query_next]);
+}
+
+void DynamicResolution::end_scene()
+{
+	if(!_enabled)
+		return;
+
+	if(gpu_timing() && _query_pending < Queries)
+	{
+		glEndQueryEXT(GL_TIME_ELAPSED_EXT);
+		_query_next = (_query_next + 1) % Queries;
+		++_query_pending;
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, _display.x, _display.y);
+
+	bool saved[5];
+	for(int i = 0; i < 5; ++i)
+	{
+		saved[i] = GLState::enabled(SavedCaps[i]);
+		GLState::disable(SavedCaps[i]);
+	}
+	GLState::stencil_mask(0xffffffff);
+	GLState::color_mask(true, true, true, true);
+	glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+	_program.use();
+	vec2 scale = vec2(_size) / vec2(_display);
+	glUniform1i(_source_location, 0);
+	glUniform2f(_scale_location, scale.x, scale.y);
+	glUniform2f(_clamp_location, (_size.x - 0.5f) / _display.x, (_size.y - 0.5f) / _display.y);
+	GLState::active_texture(GL_TEXTURE0);
+	GLState::bind_texture(GL_TEXTURE_2D, _color);
+	GLState::bind_vertex_array(0);
+	GLState::bind_buffer(GL_ARRAY_BUFFER, 0);
+	GLState::enable_attributes(1u);
+	GLState::attribute_pointer(0, 2, GL_FLOAT, false, 0, Triangle);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+
+	for(int i = 0; i < 5; ++i)
+		GLState::enable(SavedCaps[i], saved[i]);
+}
+
+void DynamicResolution::frame_presented(Duration present, Duration target)
+{
+	if(!_enabled || target <= Duration::zero())
+		return;
+
+	// Results come back a few frames late, read every query that is ready without waiting on any
+	while(_query_pending > 0)
+	{
+		GLuint query = _queries[(_query_next - _query_pending + Queries) % Queries];
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuivEXT(query, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+		if(available != GL_TRUE)
+			break;
+		--_query_pending;
+
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64vEXT(query, GL_QUERY_RESULT_EXT, &elapsed);
+		GLint disjoint = 0;
+		glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+		if(disjoint)
+			continue;
+
+		double sample = elapsed * 1e-9;
+		_gpu_time = _gpu_time > 0.0 ? _gpu_time * 0.75 + sample * 0.25 : sample;
+	}
+
+	if(_cooldown > 0)
+	{
+		--_cooldown;
+		return;
+	}
+
+	double budget = seconds(target);
+	if(gpu_timing())
+	{
+		// Pixel count goes with the square of the scale
+		if(_gpu_time > budget * 0.9)
+			adjust((float) sqrt(budget * 0.8 / _gpu_time));
+		else if(_gpu_time > 0.0 && _gpu_time < budget * 0.6)
+			adjust((float) std::min(sqrt(budget * 0.8 / _gpu_time), 1.1));
+		return;
+	}
+
+	if(present > target + target / 4)
+	{
+		_on_time = 0;
+		adjust(0.9f);
+	}
+	else if(++_on_time >= ProbeFrames)
+	{
+		_on_time = 0;
+		adjust(1.05f);
+	}
+}
+
+void DynamicResolution::adjust(float factor)
+{
+	float scale = clamp(_scale * factor, _min_scale, 1.f);
+	if(abs(scale - _scale) < 0.01f)
+		return;
+
+	TRACE("DynamicResolution::adjust => Scale {:.2f} -> {:.2f}", _scale, scale);
+	_scale = scale;
+	_gpu_time = 0.0;
+	_cooldown = Cooldown;
+}
@@ -1,77 +1,160 @@
+#include "engine/resource/Buffer.hpp"
+#include "engine/GLState.hpp"
+#include "engine/Input.hpp"
+#include "engine/Script.hpp"
 #include "engine/Engine.hpp"
 
+#include <glad/glad_es3.h>
+
+#include <spdlog/sinks/ostream_sink.h>
+#include <spdlog/async_logger.h>
 #include <SDL2/SDL.h>
+#include <algorithm>
 #include <iostream>
+#include <limits>
 
 using namespace std;
 using namespace glm;
 
 unique_ptr<Engine> Engine::_inst{};
 
-Engine::Engine(int argc, char* argv[]) : _log{}, _wnd{nullptr}
+Engine::Engine(int argc, char* argv[], LogSettings const& settings) : _log{}, _level{settings.level}, _resources{make_unique<ResourceManager>()}, _files{make_unique<FileWatcher>()}, _io{make_unique<AsyncIO>()}, _input{make_unique<Input>()}, _pacer{make_unique<FramePacer>()}, _resolution{make_unique<DynamicResolution>()}, _redraw{false}, _swap_mode{SwapMode::VSync}, _wake_event{~0u}, _gles3{false}, _msaa_samples{0}, _wnd{nullptr}
 {
 	for(int i = 0; i < argc; ++i)
 		_args.push_back(string{argv[i]});
 
+	// Flushing after every line is what makes logging expensive, let the logging thread batch them
+	bool force_flush = settings.flush_interval == chrono::milliseconds::zero();
 	std::vector<spdlog::sink_ptr> sinks
 	{
-		make_shared<spdlog::sinks::ansicolor_sink>(make_shared<spdlog::sinks::stdout_sink_st>()),
-		make_shared<spdlog::sinks::simple_file_sink_st>("GoblinPi.log", true)
+		make_shared<spdlog::sinks::ansicolor_sink>(make_shared<spdlog::sinks::ostream_sink_mt>(cout, force_flush)),
+		make_shared<spdlog::sinks::simple_file_sink_mt>("GoblinPi.log", force_flush)
 	};
-	_log = make_shared<spdlog::logger>("engine", begin(sinks), end(sinks));
-	_log->set_level(spdlog::level::trace);
+	_log = make_shared<spdlog::async_logger>("engine", begin(sinks), end(sinks), settings.queue_size, settings.overflow,
+											 nullptr, settings.flush_interval);
 	spdlog::register_logger(_log);
+	set_log_level(settings.level);
+
+	if(settings.binary)
+		_records = make_unique<BinaryLog>("engine", sinks, settings.queue_size, settings.overflow, settings.flush_interval);
 
 	string cmd;
 	for(auto a : _args)
 		cmd += a + " ";
-	_log->warn("Invocation : {}", cmd);
+	// The macros go through Engine::ptr(), which is only set once the constructor has returned
+	write(spdlog::level::warn, "Invocation : {}", cmd);
 }
 
 Engine::~Engine()
-{ }
+{
+	if(_records && _records->dropped() > 0)
+		_log->warn("Engine::~Engine => {} log messages dropped", _records->dropped());
+	_records.reset();
+
+	// Joins the logging thread once everything queued has been written
+	spdlog::drop("engine");
+	_log.reset();
+}
+
+void Engine::set_log_level(spdlog::level::level_enum lvl)
+{
+	_log->set_level(lvl);
+	_level.store((int) lvl, memory_order_relaxed);
+}
 
-int Engine::run(Application* app)
+int Engine::run(Application* app, DisplaySettings const& display)
 {
 	TRACE("Engine::run => Begin");
 
 	_running = true;
 	_exit_code = 0;
 	SDL_Init(SDL_INIT_VIDEO);
+	_wake_event = SDL_RegisterEvents(1);
+	_io->notify([this] { wake(); });
 
+	SDL_DisplayMode desktop;
+	SDL_GetDesktopDisplayMode(0, &desktop);
 	SDL_DisplayMode ask_mode;
 	ask_mode.format = SDL_PIXELFORMAT_RGBA8888;
-	ask_mode.w = 1920;
-	ask_mode.h = 1080;
-	ask_mode.refresh_rate = 60;
+	ask_mode.w = display.width > 0 ? display.width : desktop.w;
+	ask_mode.h = display.height > 0 ? display.height : desktop.h;
+	ask_mode.refresh_rate = display.refresh_rate > 0 ? display.refresh_rate : desktop.refresh_rate;
+	ask_mode.driverdata = nullptr;
 	SDL_DisplayMode mode;
-	SDL_GetClosestDisplayMode(0, &ask_mode, &mode);
+	if(!SDL_GetClosestDisplayMode(0, &ask_mode, &mode))
+	{
+		WARN("Engine::run => No display mode close to {}x{}@{}, using the desktop mode", ask_mode.w, ask_mode.h, ask_mode.refresh_rate);
+		mode = desktop;
+	}
 
 	DEBUG("Engine::run => Display Mode selected : {}x{}@{}", mode.w, mode.h, mode.refresh_rate);
 
 	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_EGL, SDL_TRUE);
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, display.gles3 ? 3 : 2);
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
-	_wnd = SDL_CreateWindow("OpenGL ES 2.0 Rendering Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, mode.w, mode.h, SDL_WINDOW_SHOWN | SDL_WINDOW_OPENGL | SDL_WINDOW_FULLSCREEN);
+	SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, display.msaa_samples > 1 ? 1 : 0);
+	SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, display.msaa_samples > 1 ? display.msaa_samples : 0);
+	Uint32 flags = SDL_WINDOW_SHOWN | SDL_WINDOW_OPENGL | (display.fullscreen ? SDL_WINDOW_FULLSCREEN : 0);
+	_wnd = SDL_CreateWindow("OpenGL ES Rendering Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, mode.w, mode.h, flags);
+	if(_wnd == nullptr && display.msaa_samples > 1)
+	{
+		WARN("Engine::run => No {}x multisampled window ({}), falling back to single sampling", display.msaa_samples, SDL_GetError());
+		SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
+		SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 0);
+		_wnd = SDL_CreateWindow("OpenGL ES Rendering Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, mode.w, mode.h, flags);
+	}
 	SDL_SetWindowDisplayMode(_wnd, &mode);
 	SDL_GLContext ctx = SDL_GL_CreateContext(_wnd);
+	if(ctx == nullptr && display.gles3)
+	{
+		WARN("Engine::run => No OpenGL ES 3.0 context ({}), falling back to 2.0", SDL_GetError());
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+		ctx = SDL_GL_CreateContext(_wnd);
+	}
+	if(ctx == nullptr)
+	{
+		FATAL("Engine::run => Could not create an OpenGL ES context : {}", SDL_GetError());
+		_io->notify(nullptr);
+		delete app;
+		SDL_DestroyWindow(_wnd);
+		_wnd = nullptr;
+		SDL_Quit();
+		_wake_event = ~0u;
+		return 1;
+	}
 	SDL_GL_MakeCurrent(_wnd, ctx);
 
 	TRACE("Engine::run => Window created");
 
 	gladLoadGLES2Loader((GLADloadproc) &SDL_GL_GetProcAddress);
-	TRACE("Engine::run => OpenGL ES loaded");
+	// A 2.0 context request can still return a 3.x context, only use it when it was asked for
+	_gles3 = display.gles3 && gladLoadGLES3Loader((GLADloadproc) &SDL_GL_GetProcAddress) != 0;
+	if(!_gles3)
+		GLAD_GL_ES_VERSION_3_0 = 0;
+	TRACE("Engine::run => OpenGL ES {} loaded", _gles3 ? "3.0" : "2.0");
+
+	// The driver may round the count up or ignore the request
+	GLint samples = 0;
+	glGetIntegerv(GL_SAMPLES, &samples);
+	_msaa_samples = samples > 1 ? samples : 0;
+	if(display.msaa_samples > 1)
+		DEBUG("Engine::run => {}x multisampling requested, {} samples", display.msaa_samples, samples);
 
+	GLState::invalidate();
 	auto fb_size = framebuffer_size();
 	glViewport(0, 0, fb_size.x, fb_size.y);
 	glClearColor(0.2f, 0.2f, 0.2f, 1.f);
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_CULL_FACE);
+	GLState::enable(GL_DEPTH_TEST);
+	GLState::enable(GL_CULL_FACE);
 
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-	SDL_GL_SetSwapInterval(1);
+	swap_mode(display.swap);
+	_pacer->max_fps(display.max_fps);
+	_pacer->refresh_rate((float) mode.refresh_rate);
+	_resolution->min_scale(display.min_render_scale);
+	_resolution->enable(display.dynamic_resolution);
 	SDL_GL_SwapWindow(_wnd);
 
 	DEBUG("Engine::run => OpenGL Renderer : {}", glGetString(GL_RENDERER));
@@ -79,56 +162,91 @@ int Engine::run(Application* app)
 	DEBUG("Engine::run => OpenGL Vendor : {}", glGetString(GL_VENDOR));
 	DEBUG("Engine::run => GLSL Version : {}", glGetString(GL_SHADING_LANGUAGE_VERSION));
 
+	_files->enable(app->hot_reload());
+	if(_files->enabled())
+		DEBUG("Engine::run => Hot reload enabled ({})", _files->native() ? "inotify" : "polling");
+
+	_script = make_unique<Script>();
+
 	TRACE("Engine::run => Initializing application");
 	app->initialize();
 	TRACE("Engine::run => Application initialized");
 
 	TRACE("Engine::run => Entering main loop");
+	bool on_demand = app->on_demand();
+	_input->reset();
+	_redraw = true;
 	TimePoint last_time{};
 	Duration accumulator{};
 	while(_running)
 	{
+		if(on_demand && !_redraw.load())
+		{
+			wait(*app, accumulator, last_time);
+			_pacer->reset();
+		}
+
 		TimePoint new_time = Clock::now();
 		Duration dT = new_time - last_time;
 		last_time = new_time;
 		accumulator += dT;
 
-		SDL_Event e;
-		while(SDL_PollEvent(&e))
-		{
-			if(e.type == SDL_WINDOWEVENT_CLOSE)
-				_running = false;
-			if(e.type == SDL_KEYUP || e.type == SDL_KEYDOWN)
-				app->keyboard_event(static_cast<Key>(e.key.keysym.scancode), e.type == SDL_KEYDOWN);
-			if(e.type == SDL_TEXTINPUT)
-				app->keyboard_character_event(e.text.text);
-			if(e.type == SDL_MOUSEMOTION)
-				app->mouse_move_event({e.motion.xrel, e.motion.yrel});
-			if(e.type == SDL_MOUSEBUTTONUP || e.type == SDL_MOUSEBUTTONDOWN)
-				app->mouse_button_event({e.button.x, e.button.y}, static_cast<MouseButton>(e.button.button), e.type == SDL_MOUSEBUTTONDOWN);
-			if(e.type == SDL_MOUSEWHEEL)
-				app->scroll_event({e.wheel.x, e.wheel.y});
-			if(e.type == SDL_WINDOWEVENT_RESIZED)
-				app->resize_event(e.window.data1, e.window.data2);
-		}
+		_input->process(*app, *_script);
+		if(_input->quit_requested())
+			_running = false;
+
+		_files->poll();
+		_io->dispatch();
 
 		if(accumulator >= app->fixed_time_step())
 		{
 			app->update(accumulator);
+			_script->update(accumulator);
 			accumulator = Duration{};
 		}
 
+		if(app->resample_input())
+			_input->resample(*app, *_script);
+
+		// Cleared before drawing, a redraw requested during the frame is kept for the next one
+		if(!_redraw.exchange(false) && on_demand)
+			continue;
+
+		// Only GL calls made before end_scene() land in the scaled target, a painter frame has to end in frame()
+		_resolution->begin_scene(framebuffer_size());
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
 		app->frame_start();
 		app->frame();
+		_script->frame();
+		_resolution->end_scene();
 		app->frame_end();
 
+		_pacer->wait();
 		SDL_GL_SwapWindow(_wnd);
+		_pacer->presented();
+		_resolution->frame_presented(_pacer->stats().last, _pacer->target());
+		GLState::end_frame();
+		_resources->collect();
 	}
 
 	TRACE("Engine::run => Exited main loop");
+	DEBUG("Engine::run => {} frames presented, {:.1f} fps over the last {}, {} missed", _pacer->stats().frames, _pacer->stats().fps,
+		  FramePacer::Window, _pacer->stats().missed);
+
+	// Completions would outlive the application, drop them
+	_io->cancel_all();
+	_io->notify(nullptr);
+	// The application owns the painter it bound, the script must not point at it once it is gone
+	_script->bind(nullptr);
 	delete app;
+	_script.reset();
+	_files->enable(false);
+
+	_resolution->enable(false);
+	_resources->clear();
+	Buffer::release_recycled();
+	TRACE("Engine::run => Resources released");
 
 	SDL_GL_DeleteContext(ctx);
 	SDL_DestroyWindow(_wnd);
@@ -136,6 +254,9 @@ int Engine::run(Application* app)
 	TRACE("Engine::run => Window destroyed");
 
 	SDL_Quit();
+	_wake_event = ~0u;
+	_gles3 = false;
+	_msaa_samples = 0;
 	TRACE("Engine::run => Bye ({})\n", _exit_code);
 	return _exit_code;
 }
@@ -153,3 +274,48 @@ glm::ivec2 Engine::window_size() const
 	SDL_GetWindowSize(_wnd, &ret.x, &ret.y);
 	return ret;
 }
+
+bool Engine::swap_mode(SwapMode mode)
+{
+	int interval = mode == SwapMode::Immediate ? 0 : mode == SwapMode::VSync ? 1 : -1;
+	if(SDL_GL_SetSwapInterval(interval) == 0)
+	{
+		_swap_mode = mode;
+		DEBUG("Engine::swap_mode => Swap interval {}", interval);
+		return true;
+	}
+
+	WARN("Engine::swap_mode => Swap interval {} not supported : {}", interval, SDL_GetError());
+	if(mode == SwapMode::Adaptive && SDL_GL_SetSwapInterval(1) == 0)
+		_swap_mode = SwapMode::VSync;
+	return false;
+}
+
+void Engine::request_redraw()
+{
+	if(!_redraw.exchange(true))
+		wake();
+}
+
+void Engine::wake()
+{
+	// Only interrupts wait(), the event itself is dropped by Input
+	if(_wake_event == ~0u)
+		return;
+	SDL_Event e{};
+	e.type = _wake_event;
+	SDL_PushEvent(&e);
+}
+
+void Engine::wait(Application const& app, Duration accumulator, TimePoint last_time)
+{
+	// Leaves the event in the queue for Input, returns early for any event, a redraw or an I/O completion
+	Duration remaining = app.fixed_time_step() - accumulator - (Clock::now() - last_time);
+	if(_files->enabled())
+		remaining = std::min(remaining, _files->settle());
+	if(remaining <= Duration::zero())
+		return;
+
+	auto ms = chrono::duration_cast<chrono::milliseconds>(remaining + chrono::milliseconds(1) - Duration(1));
+	SDL_WaitEventTimeout(nullptr, (int) std::min<chrono::milliseconds::rep>(ms.count(), numeric_limits<int>::max()));
+}
@@ -0,0 +1,213 @@
+#include <engine/FileWatcher.hpp>
+
+#include <sys/stat.h>
+
+#if defined(__linux)
+# include <sys/inotify.h>
+# include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+	void stat_file(string const& path, long long& mtime, long long& size)
+	{
+		struct stat sb;
+		if(stat(path.c_str(), &sb) != 0)
+		{
+			mtime = size = -1;
+			return;
+		}
+		mtime = (long long) sb.st_mtime;
+		size = (long long) sb.st_size;
+	}
+}
+
+FileWatcher::FileWatcher(Duration settle, Duration interval) :
+		_settle(settle), _interval(interval), _last_scan(), _next(Invalid), _fd(-1), _enabled(false)
+{ }
+
+FileWatcher::~FileWatcher()
+{
+	enable(false);
+}
+
+void FileWatcher::enable(bool enabled)
+{
+	if(enabled == _enabled)
+		return;
+	_enabled = enabled;
+
+	if(!enabled)
+	{
+		_entries.clear();
+		_pending.clear();
+#if defined(__linux)
+		if(_fd >= 0)
+			close(_fd);
+#endif
+		_fd = -1;
+		return;
+	}
+
+#if defined(__linux)
+	_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::Watch FileWatcher::watch(filesystem::Path const& file, Callback callback)
+{
+	if(!_enabled)
+		return Invalid;
+
+	Entry e;
+	e.path = file;
+	e.name = file.filename();
+	e.dir = file.parent_path().str();
+	if(e.dir.empty())
+		e.dir = file.is_absolute() ? "/" : ".";
+	e.key = e.dir + "/" + e.name;
+	e.wd = -1;
+	e.callback = move(callback);
+	stat_file(file.str(), e.mtime, e.size);
+
+#if defined(__linux)
+	if(_fd >= 0)
+	{
+		// Watching the directory also catches files replaced by a rename. The same directory always gives the same
+		// wd however it is spelled, events are matched on the wd and the file name for that reason.
+		e.wd = inotify_add_watch(_fd, e.dir.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE);
+	}
+#endif
+
+	Watch id = ++_next;
+	if(id == Invalid)
+		id = ++_next;
+	_entries[id] = move(e);
+	return id;
+}
+
+void FileWatcher::unwatch(Watch watch)
+{
+	auto it = _entries.find(watch);
+	if(it == _entries.end())
+		return;
+
+	int wd = it->second.wd;
+	_entries.erase(it);
+	release(wd);
+}
+
+void FileWatcher::release(int wd)
+{
+	if(wd < 0)
+		return;
+	for(auto const& e : _entries)
+	{
+		if(e.second.wd == wd)
+			return;
+	}
+
+#if defined(__linux)
+	inotify_rm_watch(_fd, wd);
+#endif
+}
+
+void FileWatcher::read_events(TimePoint now)
+{
+#if defined(__linux)
+	alignas(inotify_event) char buffer[4096];
+	while(true)
+	{
+		ssize_t len = read(_fd, buffer, sizeof(buffer));
+		if(len <= 0)
+			break;
+
+		for(char* ptr = buffer; ptr < buffer + len; ptr += sizeof(inotify_event) + reinterpret_cast<inotify_event*>(ptr)->len)
+		{
+			auto event = reinterpret_cast<inotify_event*>(ptr);
+			if(event->mask & IN_Q_OVERFLOW)
+			{
+				// Events were lost, assume everything changed
+				for(auto const& e : _entries)
+					_pending[e.second.key] = now;
+				continue;
+			}
+			if(event->mask & IN_IGNORED)
+			{
+				// The directory went away, its files fall back to polling
+				for(auto& e : _entries)
+				{
+					if(e.second.wd == event->wd)
+						e.second.wd = -1;
+				}
+				continue;
+			}
+			if(event->len == 0)
+				continue;
+
+			for(auto const& e : _entries)
+			{
+				if(e.second.wd == event->wd && e.second.name == event->name)
+					_pending[e.second.key] = now;
+			}
+		}
+	}
+#else
+	(void) now;
+#endif
+}
+
+void FileWatcher::scan(TimePoint now)
+{
+	if(now - _last_scan < _interval)
+		return;
+	_last_scan = now;
+
+	for(auto& e : _entries)
+	{
+		if(e.second.wd >= 0)
+			continue;
+
+		long long mtime, size;
+		stat_file(e.second.path.str(), mtime, size);
+		if(mtime == e.second.mtime && size == e.second.size)
+			continue;
+		e.second.mtime = mtime;
+		e.second.size = size;
+		_pending[e.second.key] = now;
+	}
+}
+
+void FileWatcher::poll()
+{
+	if(!_enabled || _entries.empty())
+		return;
+
+	TimePoint now = Clock::now();
+	if(_fd >= 0)
+		read_events(now);
+	scan(now);
+
+	// Callbacks may watch or unwatch files, collect everything due first
+	vector<pair<Callback, filesystem::Path>> due;
+	for(auto it = _pending.begin(); it != _pending.end();)
+	{
+		if(now - it->second < _settle)
+		{
+			++it;
+			continue;
+		}
+
+		for(auto const& e : _entries)
+		{
+			if(e.second.key == it->first && e.second.path.is_file())
+				due.emplace_back(e.second.callback, e.second.path);
+		}
+		it = _pending.erase(it);
+	}
+
+	for(auto const& d : due)
+		d.first(d.second);
+}
@@ -0,0 +1,100 @@
+#include <engine/FramePacer.hpp>
+
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+FramePacer::FramePacer(float max_fps, Duration spin) :
+		_max_fps(0.f), _refresh_rate(0.f), _interval(), _spin(spin), _deadline(), _last_present(), _has_present(false), _next(0),
+		_stats{Duration{}, Duration{}, Duration{}, Duration{}, 0.f, 0, 0}
+{
+	_intervals.reserve(Window);
+	_late.reserve(Window);
+	this->max_fps(max_fps);
+}
+
+void FramePacer::max_fps(float fps)
+{
+	_max_fps = max(fps, 0.f);
+	_interval = _max_fps > 0.f ? duration_cast<Duration>(chrono::duration<double>(1.0 / _max_fps)) : Duration{};
+	_deadline = TimePoint{};
+}
+
+void FramePacer::refresh_rate(float hz)
+{
+	_refresh_rate = max(hz, 0.f);
+}
+
+void FramePacer::wait()
+{
+	if(_interval == Duration::zero())
+		return;
+
+	TimePoint now = Clock::now();
+	_deadline += _interval;
+	if(_deadline < now - _interval || _deadline > now + _interval)
+		_deadline = now;
+
+	if(_deadline - now > _spin)
+		this_thread::sleep_until(_deadline - _spin);
+	while(Clock::now() < _deadline)
+		this_thread::yield();
+}
+
+void FramePacer::presented()
+{
+	TimePoint now = Clock::now();
+	if(!_has_present)
+	{
+		_last_present = now;
+		_has_present = true;
+		return;
+	}
+
+	Duration last = now - _last_present;
+	_last_present = now;
+
+	Duration expected = target();
+	bool late = expected > Duration::zero() && last > expected + expected / 2;
+	if(_intervals.size() < Window)
+	{
+		_intervals.push_back(last);
+		_late.push_back(late);
+	}
+	else
+	{
+		_intervals[_next] = last;
+		_late[_next] = late;
+	}
+	_next = (_next + 1) % Window;
+
+	Duration sum{};
+	_stats.min = _stats.max = last;
+	for(auto const& i : _intervals)
+	{
+		sum += i;
+		_stats.min = std::min(_stats.min, i);
+		_stats.max = std::max(_stats.max, i);
+	}
+	_stats.last = last;
+	_stats.average = sum / _intervals.size();
+	_stats.fps = _stats.average > Duration::zero() ? (float) (1.0 / chrono::duration<double>(_stats.average).count()) : 0.f;
+	_stats.missed = (size_t) count(_late.begin(), _late.end(), true);
+	++_stats.frames;
+}
+
+void FramePacer::reset()
+{
+	_has_present = false;
+	_deadline = TimePoint{};
+}
+
+Duration FramePacer::target() const
+{
+	if(_interval > Duration::zero())
+		return _interval;
+	if(_refresh_rate > 0.f)
+		return duration_cast<Duration>(chrono::duration<double>(1.0 / _refresh_rate));
+	return Duration{};
+}
@@ -0,0 +1,346 @@
+#include <engine/GLState.hpp>
+
+#include <glad/glad_es3.h>
+
+#include <tuple>
+
+using namespace std;
+
+namespace
+{
+	template<typename T>
+	struct Cached
+	{
+		T value;
+		bool known;
+
+		bool set(T const& v)
+		{
+			if(known && value == v)
+				return false;
+			value = v;
+			known = true;
+			return true;
+		}
+	};
+
+	typedef tuple<GLuint, GLint, GLenum, bool, GLsizei, void const*> AttributePointer;
+
+	const int MaxCapabilities = 9;
+	const GLenum Capabilities[MaxCapabilities]
+	{
+		GL_BLEND,
+		GL_CULL_FACE,
+		GL_DEPTH_TEST,
+		GL_SCISSOR_TEST,
+		GL_STENCIL_TEST,
+		GL_DITHER,
+		GL_POLYGON_OFFSET_FILL,
+		GL_SAMPLE_ALPHA_TO_COVERAGE,
+		GL_SAMPLE_COVERAGE
+	};
+
+	const int MaxTextureUnits = 8;
+	const int MaxAttributes = 16;
+
+	struct State
+	{
+		Cached<bool> caps[MaxCapabilities];
+		Cached<GLuint> program;
+		Cached<GLuint> array_buffer;
+		Cached<GLuint> element_buffer;
+		Cached<GLenum> active_unit;
+		Cached<GLuint> textures[MaxTextureUnits];
+		Cached<tuple<GLenum, GLenum>> blend_func;
+		Cached<GLenum> cull_face;
+		Cached<GLenum> front_face;
+		Cached<tuple<bool, bool, bool, bool>> color_mask;
+		Cached<GLuint> stencil_mask;
+		Cached<tuple<GLenum, GLint, GLuint>> stencil_func;
+		Cached<tuple<GLenum, GLenum, GLenum>> stencil_op_front;
+		Cached<tuple<GLenum, GLenum, GLenum>> stencil_op_back;
+		Cached<bool> attributes[MaxAttributes];
+		Cached<AttributePointer> pointers[MaxAttributes];
+		Cached<tuple<void const*, GLuint, glm::int64>> layout;
+		Cached<GLuint> vertex_array;
+	};
+
+	State state{};
+	GLState::Stats current{}, last{};
+
+	inline bool count(bool changed)
+	{
+		if(changed)
+			++current.changes;
+		else
+			++current.filtered;
+		return changed;
+	}
+
+	inline int capability_slot(GLenum cap)
+	{
+		for(int i = 0; i < MaxCapabilities; ++i)
+			if(Capabilities[i] == cap)
+				return i;
+		return -1;
+	}
+
+	inline Cached<GLuint>* current_texture()
+	{
+		if(!state.active_unit.known)
+			return nullptr;
+		GLenum unit = state.active_unit.value - GL_TEXTURE0;
+		return unit < MaxTextureUnits ? &state.textures[unit] : nullptr;
+	}
+}
+
+void GLState::invalidate()
+{
+	state = State{};
+}
+
+void GLState::end_frame()
+{
+	last = current;
+	current = Stats{};
+}
+
+GLState::Stats const& GLState::frame_stats()
+{
+	return last;
+}
+
+void GLState::enable(GLenum cap, bool enabled)
+{
+	int slot = capability_slot(cap);
+	if(slot >= 0 && !count(state.caps[slot].set(enabled)))
+		return;
+
+	if(enabled)
+		glEnable(cap);
+	else
+		glDisable(cap);
+}
+
+bool GLState::enabled(GLenum cap)
+{
+	int slot = capability_slot(cap);
+	if(slot >= 0 && state.caps[slot].known)
+		return state.caps[slot].value;
+
+	bool enabled = glIsEnabled(cap) == GL_TRUE;
+	if(slot >= 0)
+		state.caps[slot].set(enabled);
+	return enabled;
+}
+
+void GLState::use_program(GLuint program)
+{
+	if(count(state.program.set(program)))
+		glUseProgram(program);
+}
+
+void GLState::bind_buffer(GLenum target, GLuint buffer)
+{
+	bool changed = true;
+	if(target == GL_ARRAY_BUFFER)
+		changed = count(state.array_buffer.set(buffer));
+	else if(target == GL_ELEMENT_ARRAY_BUFFER)
+		changed = count(state.element_buffer.set(buffer));
+
+	if(changed)
+		glBindBuffer(target, buffer);
+}
+
+void GLState::active_texture(GLenum unit)
+{
+	if(count(state.active_unit.set(unit)))
+		glActiveTexture(unit);
+}
+
+void GLState::bind_texture(GLenum target, GLuint texture)
+{
+	Cached<GLuint>* cached = target == GL_TEXTURE_2D ? current_texture() : nullptr;
+	if(cached != nullptr && !count(cached->set(texture)))
+		return;
+
+	glBindTexture(target, texture);
+}
+
+void GLState::blend_func(GLenum src, GLenum dst)
+{
+	if(count(state.blend_func.set(make_tuple(src, dst))))
+		glBlendFunc(src, dst);
+}
+
+void GLState::cull_face(GLenum mode)
+{
+	if(count(state.cull_face.set(mode)))
+		glCullFace(mode);
+}
+
+void GLState::front_face(GLenum mode)
+{
+	if(count(state.front_face.set(mode)))
+		glFrontFace(mode);
+}
+
+void GLState::color_mask(bool r, bool g, bool b, bool a)
+{
+	if(count(state.color_mask.set(make_tuple(r, g, b, a))))
+		glColorMask((GLboolean) r, (GLboolean) g, (GLboolean) b, (GLboolean) a);
+}
+
+void GLState::stencil_mask(GLuint mask)
+{
+	if(count(state.stencil_mask.set(mask)))
+		glStencilMask(mask);
+}
+
+void GLState::stencil_func(GLenum func, GLint ref, GLuint mask)
+{
+	if(count(state.stencil_func.set(make_tuple(func, ref, mask))))
+		glStencilFunc(func, ref, mask);
+}
+
+void GLState::stencil_op(GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+	auto op = make_tuple(sfail, dpfail, dppass);
+	bool front = state.stencil_op_front.set(op);
+	bool back = state.stencil_op_back.set(op);
+	if(count(front || back))
+		glStencilOp(sfail, dpfail, dppass);
+}
+
+void GLState::stencil_op_separate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+	auto op = make_tuple(sfail, dpfail, dppass);
+	bool changed = false;
+	if(face == GL_FRONT || face == GL_FRONT_AND_BACK)
+		changed |= state.stencil_op_front.set(op);
+	if(face == GL_BACK || face == GL_FRONT_AND_BACK)
+		changed |= state.stencil_op_back.set(op);
+	if(count(changed))
+		glStencilOpSeparate(face, sfail, dpfail, dppass);
+}
+
+void GLState::enable_attribute(GLuint index, bool enabled)
+{
+	if(index < MaxAttributes && !count(state.attributes[index].set(enabled)))
+		return;
+
+	state.layout.known = false;
+	if(enabled)
+		glEnableVertexAttribArray(index);
+	else
+		glDisableVertexAttribArray(index);
+}
+
+void GLState::attribute_pointer(GLuint index, GLint size, GLenum type, bool normalized, GLsizei stride, void const* ptr)
+{
+	// The pointer is relative to the buffer bound when it was specified, so that buffer is part of the key
+	if(index < MaxAttributes)
+	{
+		if(!state.array_buffer.known)
+			state.pointers[index].known = false;
+		else if(!count(state.pointers[index].set(make_tuple(state.array_buffer.value, size, type, normalized, stride, ptr))))
+			return;
+	}
+
+	state.layout.known = false;
+	glVertexAttribPointer(index, size, type, (GLboolean) (normalized ? GL_TRUE : GL_FALSE), stride, ptr);
+}
+
+void GLState::enable_attributes(glm::uint mask)
+{
+	for(GLuint i = 0; i < MaxAttributes; ++i)
+	{
+		bool enabled = (mask & (1u << i)) != 0;
+		// Attributes in an unknown state are only touched when they are wanted
+		if(enabled || state.attributes[i].known)
+			enable_attribute(i, enabled);
+	}
+}
+
+bool GLState::layout_current(void const* layout, glm::int64 base)
+{
+	bool applied = state.layout.known && state.array_buffer.known &&
+				   state.layout.value == make_tuple(layout, state.array_buffer.value, base);
+	if(applied)
+		count(false);
+	return applied;
+}
+
+void GLState::layout_applied(void const* layout, glm::int64 base)
+{
+	if(state.array_buffer.known)
+		state.layout.set(make_tuple(layout, state.array_buffer.value, base));
+}
+
+void GLState::bind_vertex_array(GLuint array)
+{
+	if(!count(state.vertex_array.set(array)))
+		return;
+
+	for(auto& a : state.attributes)
+		a.known = false;
+	for(auto& p : state.pointers)
+		p.known = false;
+	state.layout.known = false;
+	state.element_buffer.known = false;
+
+	if(GLAD_GL_ES_VERSION_3_0)
+		glBindVertexArray(array);
+	else if(GLAD_GL_OES_vertex_array_object)
+		glBindVertexArrayOES(array);
+}
+
+void GLState::delete_buffers(GLsizei n, GLuint const* buffers)
+{
+	for(GLsizei i = 0; i < n; ++i)
+	{
+		// GL silently unbinds deleted buffers, follow along
+		if(state.array_buffer.known && state.array_buffer.value == buffers[i])
+			state.array_buffer.value = 0;
+		if(state.element_buffer.known && state.element_buffer.value == buffers[i])
+			state.element_buffer.value = 0;
+		for(auto& p : state.pointers)
+			if(p.known && get<0>(p.value) == buffers[i])
+				p.known = false;
+		if(state.layout.known && get<1>(state.layout.value) == buffers[i])
+			state.layout.known = false;
+	}
+	glDeleteBuffers(n, buffers);
+}
+
+void GLState::delete_textures(GLsizei n, GLuint const* textures)
+{
+	for(GLsizei i = 0; i < n; ++i)
+		for(auto& t : state.textures)
+			if(t.known && t.value == textures[i])
+				t.value = 0;
+	glDeleteTextures(n, textures);
+}
+
+void GLState::delete_program(GLuint program)
+{
+	// A program in use is only flagged for deletion but its name can be handed out again right away
+	if(state.program.known && state.program.value == program)
+		state.program.known = false;
+	glDeleteProgram(program);
+}
+
+void GLState::delete_vertex_arrays(GLsizei n, GLuint const* arrays)
+{
+	for(GLsizei i = 0; i < n; ++i)
+	{
+		// GL reverts to array 0 when the bound array is deleted, switch first so the attribute cache follows
+		if(state.vertex_array.known && state.vertex_array.value == arrays[i] && arrays[i] != 0)
+			bind_vertex_array(0);
+	}
+
+	if(GLAD_GL_ES_VERSION_3_0)
+		glDeleteVertexArrays(n, arrays);
+	else if(GLAD_GL_OES_vertex_array_object)
+		glDeleteVertexArraysOES(n, arrays);
+}
@@ -0,0 +1,159 @@
+#include <engine/Application.hpp>
+#include <engine/Script.hpp>
+#include <engine/Input.hpp>
+
+#include <SDL2/SDL.h>
+
+using namespace std;
+using namespace glm;
+
+namespace
+{
+	// Peeked at once by resample(), more motion than this behind the front of the queue waits for the next frame
+	const int ResampleBatch = 64;
+}
+
+Input::Input() : _buttons(0), _buttons_pressed(0), _buttons_released(0), _position(0), _delta(0), _scroll(0), _pending(0),
+				 _has_pending(false), _coalesce(true), _quit(false), _motion_events(0), _motion_dispatched(0)
+{ }
+
+void Input::reset()
+{
+	_keys.reset();
+	_pressed.reset();
+	_released.reset();
+	_buttons = _buttons_pressed = _buttons_released = 0;
+	_position = _delta = _scroll = _pending = ivec2(0);
+	_has_pending = false;
+	_quit = false;
+	_motion_events = _motion_dispatched = 0;
+}
+
+void Input::process(Application& app, Script& script)
+{
+	_pressed.reset();
+	_released.reset();
+	_buttons_pressed = _buttons_released = 0;
+	_delta = _scroll = ivec2(0);
+	_motion_events = _motion_dispatched = 0;
+
+	SDL_Event e;
+	while(SDL_PollEvent(&e))
+		handle(e, app, script);
+	flush_motion(app, script);
+}
+
+void Input::resample(Application& app, Script& script)
+{
+	SDL_PumpEvents();
+
+	SDL_Event events[ResampleBatch];
+	int count = SDL_PeepEvents(events, ResampleBatch, SDL_PEEKEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+	int leading = 0;
+	while(leading < count && events[leading].type == SDL_MOUSEMOTION)
+		++leading;
+	if(leading == 0)
+		return;
+
+	// The first motion events in the queue are the ones peeked, taking them leaves everything else in order
+	leading = SDL_PeepEvents(events, leading, SDL_GETEVENT, SDL_MOUSEMOTION, SDL_MOUSEMOTION);
+	for(int i = 0; i < leading; ++i)
+		handle(events[i], app, script);
+	flush_motion(app, script);
+}
+
+void Input::handle(SDL_Event const& e, Application& app, Script& script)
+{
+	if(e.type == SDL_MOUSEMOTION)
+	{
+		motion({e.motion.x, e.motion.y}, {e.motion.xrel, e.motion.yrel}, app, script);
+		return;
+	}
+
+	flush_motion(app, script);
+	switch(e.type)
+	{
+		case SDL_QUIT:
+			_quit = true;
+			break;
+		case SDL_WINDOWEVENT:
+			if(e.window.event == SDL_WINDOWEVENT_CLOSE)
+				_quit = true;
+			if(e.window.event == SDL_WINDOWEVENT_RESIZED)
+				app.resize_event(e.window.data1, e.window.data2);
+			// The window contents are gone, on demand applications would otherwise show garbage until their next redraw
+			if(e.window.event == SDL_WINDOWEVENT_EXPOSED || e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+			   e.window.event == SDL_WINDOWEVENT_RESTORED)
+				Engine::ref().request_redraw();
+			break;
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+		{
+			Key key = static_cast<Key>(e.key.keysym.scancode);
+			bool pressed = e.type == SDL_KEYDOWN;
+			if(!e.key.repeat)
+			{
+				_keys.set(index(key), pressed);
+				(pressed ? _pressed : _released).set(index(key));
+			}
+			app.keyboard_event(key, pressed);
+			script.keyboard(key, pressed);
+			break;
+		}
+		case SDL_TEXTINPUT:
+			app.keyboard_character_event(e.text.text);
+			script.character(e.text.text);
+			break;
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP:
+		{
+			MouseButton button = static_cast<MouseButton>(e.button.button);
+			bool pressed = e.type == SDL_MOUSEBUTTONDOWN;
+			_position = {e.button.x, e.button.y};
+			if(pressed)
+			{
+				_buttons |= mask(button);
+				_buttons_pressed |= mask(button);
+			}
+			else
+			{
+				_buttons &= ~mask(button);
+				_buttons_released |= mask(button);
+			}
+			app.mouse_button_event(_position, button, pressed);
+			script.mouse_button(_position, button, pressed);
+			break;
+		}
+		case SDL_MOUSEWHEEL:
+			_scroll += ivec2(e.wheel.x, e.wheel.y);
+			app.scroll_event({e.wheel.x, e.wheel.y});
+			script.scroll({e.wheel.x, e.wheel.y});
+			break;
+		default:
+			break;
+	}
+}
+
+void Input::motion(ivec2 const& position, ivec2 const& delta, Application& app, Script& script)
+{
+	++_motion_events;
+	_position = position;
+	_delta += delta;
+	_pending += delta;
+	_has_pending = true;
+	if(!_coalesce)
+		flush_motion(app, script);
+}
+
+void Input::flush_motion(Application& app, Script& script)
+{
+	if(!_has_pending)
+		return;
+
+	ivec2 delta = _pending;
+	_pending = ivec2(0);
+	_has_pending = false;
+	++_motion_dispatched;
+	app.mouse_move_event(delta);
+	script.mouse_move(delta);
+}
@@ -1,14 +1,46 @@
 #include <engine/utils/FileSystem.hpp>
+#include <engine/utils/Archive.hpp>
+#include <engine/resource/Program.hpp>
+#include <engine/GLState.hpp>
 #include <engine/Painter.hpp>
-#include <glad/glad.h>
+#include <engine/Series.hpp>
+#include <engine/Engine.hpp>
+#include <glad/glad_es3.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstddef>
+#include <cmath>
+
+// Shared with the GLES3 backend in PainterGLES3.cpp
+GLuint glnvgLinkProgram(char const* name, char const* header, char const* opts, char const* vshader, char const* fshader)
+{
+	try
+	{
+		return Program::link(std::string{header} + opts + vshader, std::string{header} + opts + fshader, {{0, "vertex"}, {1, "tcoord"}});
+	}
+	catch(std::exception const& e)
+	{
+		ERR("Painter => Could not build nanovg program '{}' : {}", name, e.what());
+		return 0;
+	}
+}
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
+#define NANOVG_GL_USE_PROGRAM_CACHE 1
+#define NANOVG_GL_USE_STATE_CACHE 1
 #define NANOVG_GLES2_IMPLEMENTATION
 #include "deps/nanovg/nanovg.h"
 #include "deps/nanovg/nanovg_gl.h"
 #pragma GCC diagnostic pop
 
+// Built in PainterGLES3.cpp, nanovg_gl.h only declares the backend it implements
+extern "C" {
+NVGcontext* nvgCreateGLES3(int flags);
+void nvgDeleteGLES3(NVGcontext* ctx);
+int nvglCreateImageFromHandleGLES3(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
+}
+
 using namespace glm;
 using namespace std;
 
@@ -55,17 +87,114 @@ Paint from_nvg(NVGpaint const& paint)
 	};
 }
 
-Painter::Painter() : _vg(nvgCreateGLES2(NVG_ANTIALIAS | NVG_STENCIL_STROKES | NVG_DEBUG))
-{ }
+namespace
+{
+	// Keeps the first, lowest, highest and last point of each pixel column, in the order they come
+	class Decimator
+	{
+	public:
+		Decimator(vector<vec2>& out, float scale, float offset) : _out(out), _scale(scale), _offset(offset), _column(0), _open(false),
+																  _node{}
+		{ _out.clear(); }
+
+		void add(Series::Node const& node)
+		{
+			float column = floor(node.first.x * _scale + _offset);
+			if(_open && column == _column)
+			{
+				if(node.low.y < _node.low.y)
+					_node.low = node.low;
+				if(node.high.y > _node.high.y)
+					_node.high = node.high;
+				_node.last = node.last;
+				return;
+			}
+
+			finish();
+			_column = column;
+			_node = node;
+			_open = true;
+		}
+
+		void add(vec2 const& point)
+		{ add({point, point, point, point}); }
+
+		void finish()
+		{
+			if(!_open)
+				return;
+			_open = false;
+
+			emit(_node.first);
+			bool low_first = _node.low.x <= _node.high.x;
+			emit(low_first ? _node.low : _node.high);
+			emit(low_first ? _node.high : _node.low);
+			emit(_node.last);
+		}
+
+	private:
+		void emit(vec2 const& point)
+		{
+			if(_out.empty() || point != _out.back())
+				_out.push_back(point);
+		}
+
+		vector<vec2>& _out;
+		float _scale;
+		float _offset;
+		float _column;
+		bool _open;
+		Series::Node _node;
+	};
+
+	// Fonts are parsed lazily as glyphs are needed. A mapped file truncated in place would then fault on the
+	// next uncached glyph, so loose font files live in a heap copy that nanovg frees along with the font.
+	unsigned char* heap_copy(unsigned char const* data, size_t size)
+	{
+		auto ret = static_cast<unsigned char*>(malloc(size));
+		if(ret == nullptr) throw bad_alloc();
+		copy(data, data + size, ret);
+		return ret;
+	}
+}
+
+Painter::Painter(Antialias antialias) : _vg(nullptr), _gles3(GLAD_GL_ES_VERSION_3_0 != 0), _antialias(antialias), _frame_size(0),
+										_pixel_ratio(1.f)
+{
+	// The offscreen scene target of DynamicResolution has a single sample whatever the backbuffer has
+	if(_antialias == Antialias::Auto)
+	{
+		bool multisampled = Engine::ptr() != nullptr && Engine::ref().msaa_samples() > 1 && !Engine::ref().resolution().enabled();
+		_antialias = multisampled ? Antialias::Multisample : Antialias::Geometry;
+	}
+
+	// The GLES3 backend keeps its uniforms in a buffer and its vertex state in a vertex array object
+	int flags = NVG_STENCIL_STROKES | NVG_DEBUG | (_antialias == Antialias::Geometry ? NVG_ANTIALIAS : 0);
+	_vg = _gles3 ? nvgCreateGLES3(flags) : nvgCreateGLES2(flags);
+	DEBUG("Painter::Painter => {} backend, {} antialiasing", _gles3 ? "GLES3" : "GLES2",
+		  _antialias == Antialias::Geometry ? "geometry" : "multisample");
+}
 
 Painter::~Painter()
 {
-	nvgDeleteGLES2(_vg);
+	if(Engine::ptr() != nullptr)
+	{
+		for(auto const& w : _image_watches)
+			Engine::ref().files().unwatch(w.second);
+		for(auto const& w : _font_watches)
+			Engine::ref().files().unwatch(w.second);
+	}
+	if(_gles3)
+		nvgDeleteGLES3(_vg);
+	else
+		nvgDeleteGLES2(_vg);
 	_vg = nullptr;
 }
 
 void Painter::begin_frame(ivec2 const& size, float pixelratio)
 {
+	_frame_size = size;
+	_pixel_ratio = pixelratio;
 	nvgBeginFrame(_vg, size.x, size.y, pixelratio);
 }
 
@@ -76,9 +205,19 @@ void Painter::cancel_frame()
 
 void Painter::end_frame()
 {
+	// The GLES2 backend sets its attributes on whatever vertex array is bound
+	if(!_gles3)
+		GLState::bind_vertex_array(0);
 	nvgEndFrame(_vg);
 }
 
+Painter::Stats Painter::frame_stats() const
+{
+	NVGframeStats stats;
+	nvgFrameStats(_vg, &stats);
+	return {stats.drawCalls, stats.triangles, stats.vertices};
+}
+
 void Painter::save()
 {
 	nvgSave(_vg);
@@ -186,7 +325,10 @@ mat2x3 Painter::current_transform()
 int Painter::create_image(string const& file, ImageFlags flags)
 {
 	if(!filesystem::Path(file).exists()) throw std::invalid_argument("Image file '" + file + "' does not exist");
-	return nvgCreateImage(_vg, file.c_str(), static_cast<int>(flags));
+	int id = create_image(filesystem::MappedFile{file}, flags);
+	if(id != 0)
+		watch(_image_watches, id, file, false);
+	return id;
 }
 
 int Painter::create_image(unsigned char const* data, int size, ImageFlags flags)
@@ -194,6 +336,49 @@ int Painter::create_image(unsigned char const* data, int size, ImageFlags flags)
 	return nvgCreateImageMem(_vg, static_cast<int>(flags), data, size);
 }
 
+int Painter::create_image(filesystem::MappedFile const& file, ImageFlags flags)
+{
+	// Decoded right away, the mapping is not needed once the texture is uploaded
+	file.will_need();
+	return create_image(file.data(), (int) file.size(), flags);
+}
+
+int Painter::create_image(Archive const& archive, string const& file, ImageFlags flags)
+{
+	auto view = archive.view(file);
+	if(view.data != nullptr)
+		return create_image(view.data, (int) view.size, flags);
+	return create_image(archive.read(file), flags);
+}
+
+bool Painter::reload_image(int id, string const& file)
+{
+	filesystem::MappedFile mapped{file};
+	return nvgReloadImageMem(_vg, id, mapped.data(), (int) mapped.size()) != 0;
+}
+
+void Painter::watch(map<int, FileWatcher::Watch>& watches, int id, string const& file, bool font)
+{
+	if(Engine::ptr() == nullptr || !Engine::ref().files().enabled())
+		return;
+
+	auto watch = Engine::ref().files().watch(file, [this, id, font](filesystem::Path const& path)
+	{
+		try
+		{
+			if(font ? reload_font(id, path.str()) : reload_image(id, path.str()))
+				INFO("Painter => Reloaded {} '{}'", font ? "font" : "image", path.str());
+			else
+				WARN("Painter => Could not reload {} '{}'", font ? "font" : "image", path.str());
+		}
+		catch(exception const& e)
+		{
+			WARN("Painter => Could not reload '{}' : {}", path.str(), e.what());
+		}
+	});
+	watches[id] = watch;
+}
+
 ivec2 Painter::image_size(int id)
 {
 	ivec2 ret;
@@ -203,7 +388,55 @@ ivec2 Painter::image_size(int id)
 
 void Painter::delete_image(int id)
 {
+	auto watch = _image_watches.find(id);
+	if(watch != _image_watches.end())
+	{
+		Engine::ref().files().unwatch(watch->second);
+		_image_watches.erase(watch);
+	}
 	nvgDeleteImage(_vg, id);
+	_videos.erase(id);
+}
+
+int Painter::create_image(ivec2 const& size, unsigned char const* pixels, ImageFlags flags)
+{
+	return nvgCreateImageRGBA(_vg, size.x, size.y, static_cast<int>(flags), pixels);
+}
+
+void Painter::update_image(int id, unsigned char const* pixels)
+{
+	nvgUpdateImage(_vg, id, pixels);
+}
+
+void Painter::update_image(int id, unsigned char const* pixels, ivec2 const& pos, ivec2 const& size)
+{
+	nvgUpdateImageRegion(_vg, id, pos.x, pos.y, size.x, size.y, pixels);
+}
+
+int Painter::create_video_image(ivec2 const& size, PlaneFormat format, ImageFlags flags)
+{
+	// nanovg only samples the converted texture, the video texture keeps ownership of it
+	unique_ptr<VideoTexture> video{new VideoTexture};
+	video->create(size, format);
+	int image_flags = static_cast<int>(flags) | NVG_IMAGE_NODELETE;
+	int id = _gles3 ? nvglCreateImageFromHandleGLES3(_vg, video->texture(), size.x, size.y, image_flags)
+					: nvglCreateImageFromHandleGLES2(_vg, video->texture(), size.x, size.y, image_flags);
+	if(id != 0)
+		_videos[id] = move(video);
+	return id;
+}
+
+void Painter::update_video_image(int id, unsigned char const* const* planes, int const* strides)
+{
+	auto video = _videos.find(id);
+	if(video != _videos.end())
+		video->second->update(planes, strides);
+}
+
+VideoTexture* Painter::video_image(int id)
+{
+	auto video = _videos.find(id);
+	return video != _videos.end() ? video->second.get() : nullptr;
 }
 
 void Painter::scissor(vec2 const& pos, vec2 const& size)
@@ -296,10 +529,168 @@ void Painter::stroke()
 	nvgStroke(_vg);
 }
 
+void Painter::path(PathCommand const* commands, size_t count, vec2 const* points, size_t point_count)
+{
+	static_assert(sizeof(vec2) == 2 * sizeof(float), "Points are handed to nanovg as x,y pairs");
+	nvgAppendPath(_vg, reinterpret_cast<unsigned char const*>(commands), (int) count, &points[0].x, (int) point_count);
+}
+
+void Painter::line_strip(vec2 const* points, size_t count)
+{
+	if(count > 0)
+		nvgLineStrip(_vg, &points[0].x, (int) count);
+}
+
+bool Painter::visible_columns(vec2 const* points, size_t count, size_t& begin, size_t& end, vec2& columns) const
+{
+	float m[6];
+	nvgCurrentTransform(_vg, m);
+	// Pixel columns only line up with x when the transform neither rotates nor skews
+	if(m[0] == 0.f || m[1] != 0.f || m[2] != 0.f)
+		return false;
+
+	// Visible x range of the frame, one point more on each side so the line leaves the screen
+	float x0 = -m[4] / m[0], x1 = (_frame_size.x - m[4]) / m[0];
+	if(x0 > x1)
+		swap(x0, x1);
+	auto at = [&](size_t i) { return points[i].x; };
+	size_t lo = 0, hi = count;
+	while(lo < hi)
+	{
+		size_t mid = (lo + hi) / 2;
+		if(at(mid) < x0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	begin = lo > 0 ? lo - 1 : 0;
+	hi = count;
+	while(lo < hi)
+	{
+		size_t mid = (lo + hi) / 2;
+		if(at(mid) <= x1)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	end = std::min(lo + 1, count);
+
+	// Device pixels per unit of x and where x = 0 falls
+	columns = vec2(m[0], m[4]) * _pixel_ratio;
+	return true;
+}
+
+void Painter::polyline(vec2 const* points, size_t count)
+{
+	if(count == 0)
+		return;
+
+	size_t begin = 0, end = count;
+	vec2 columns;
+	if(!visible_columns(points, count, begin, end, columns))
+	{
+		line_strip(points, count);
+		return;
+	}
+
+	Decimator decimator(_decimated, columns.x, columns.y);
+	for(size_t i = begin; i < end; ++i)
+		decimator.add(points[i]);
+	decimator.finish();
+	line_strip(_decimated);
+}
+
+void Painter::polyline(Series const& series)
+{
+	if(series.empty())
+		return;
+
+	size_t begin = 0, end = series.size();
+	vec2 columns;
+	if(!visible_columns(series.points().data(), series.size(), begin, end, columns))
+	{
+		polyline(series.points().data(), series.size());
+		return;
+	}
+
+	// Coarsest level whose nodes cover no more points than a pixel column holds on average
+	auto const& points = series.points();
+	float width = std::min(abs(points[end - 1].x - points[begin].x) * abs(columns.x), _frame_size.x * _pixel_ratio);
+	float per_column = (float) (end - begin) / std::max(width, 1.f);
+	size_t level = series.levels();
+	while(level > 0 && (float) Series::span(level - 1) > per_column)
+		--level;
+
+	Decimator decimator(_decimated, columns.x, columns.y);
+	if(level == 0)
+	{
+		for(size_t i = begin; i < end; ++i)
+			decimator.add(points[i]);
+	}
+	else
+	{
+		auto const& nodes = series.level(level - 1);
+		size_t span = Series::span(level - 1);
+		for(size_t i = begin / span; i <= (end - 1) / span; ++i)
+			decimator.add(nodes[i]);
+	}
+	decimator.finish();
+	line_strip(_decimated);
+}
+
 int Painter::create_font(string const& name, string const& file)
 {
 	if(!filesystem::Path(file).exists()) throw std::invalid_argument("Font file '" + file + "' does not exist");
-	return nvgCreateFont(_vg, name.c_str(), file.c_str());
+	int id = create_font(name, filesystem::MappedFile{file});
+	if(id >= 0)
+		watch(_font_watches, id, file, true);
+	return id;
+}
+
+int Painter::create_font(string const& name, unsigned char const* data, int size)
+{
+	// Font data is only ever read, nanovg just lacks the const
+	return nvgCreateFontMem(_vg, name.c_str(), const_cast<unsigned char*>(data), size, 0);
+}
+
+int Painter::create_font(string const& name, filesystem::MappedFile const& file)
+{
+	file.will_need();
+	return nvgCreateFontMem(_vg, name.c_str(), heap_copy(file.data(), file.size()), (int) file.size(), 1);
+}
+
+int Painter::create_font(string const& name, Archive const& archive, string const& file)
+{
+	auto view = archive.view(file);
+	if(view.data != nullptr)
+		return create_font(name, view.data, (int) view.size);
+
+	// Compressed fonts are unpacked once into a buffer nanovg frees along with the font
+	size_t size = archive.size(file);
+	auto data = static_cast<unsigned char*>(malloc(size));
+	if(data == nullptr) throw bad_alloc();
+	try
+	{
+		archive.read(file, data);
+	}
+	catch(...)
+	{
+		free(data);
+		throw;
+	}
+	return nvgCreateFontMem(_vg, name.c_str(), data, (int) size, 1);
+}
+
+bool Painter::reload_font(int id, string const& file)
+{
+	filesystem::MappedFile mapped{file};
+	auto data = heap_copy(mapped.data(), mapped.size());
+	if(!nvgReplaceFontMem(_vg, id, data, (int) mapped.size(), 1))
+	{
+		free(data);
+		return false;
+	}
+	return true;
 }
 
 int Painter::find_font(string const& name)
@@ -347,6 +738,22 @@ float Painter::text(vec2 const& pos, string const& str)
 	return nvgText(_vg, pos.x, pos.y, str.c_str(), 0);
 }
 
+void Painter::text_batch(TextLabel const* labels, size_t count)
+{
+	static_assert(sizeof(TextLabel) == sizeof(NVGtextLabel) && offsetof(TextLabel, text) == offsetof(NVGtextLabel, string) &&
+				  offsetof(TextLabel, end) == offsetof(NVGtextLabel, end), "TextLabel is handed to nanovg as NVGtextLabel");
+	nvgTextBatch(_vg, reinterpret_cast<NVGtextLabel const*>(labels), (int) count);
+}
+
+void Painter::text_batch(vector<vec2> const& positions, vector<string> const& strings)
+{
+	size_t count = std::min(positions.size(), strings.size());
+	_labels.resize(count);
+	for(size_t i = 0; i < count; ++i)
+		_labels[i] = {positions[i], strings[i].data(), strings[i].data() + strings[i].size()};
+	text_batch(_labels);
+}
+
 void Painter::text_box(vec2 const& pos, float width, string const& str)
 {
 	nvgTextBox(_vg, pos.x, pos.y, width, str.c_str(), 0);
@@ -0,0 +1,17 @@
+#include <engine/resource/Program.hpp>
+#include <engine/GLState.hpp>
+#include <engine/Engine.hpp>
+#include <glad/glad_es3.h>
+
+GLuint glnvgLinkProgram(char const* name, char const* header, char const* opts, char const* vshader, char const* fshader);
+
+// Painter.cpp holds the GLES2 backend, both live in the same binary and the context picks one at runtime
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#define NANOVG_GL_USE_PROGRAM_CACHE 1
+#define NANOVG_GL_USE_STATE_CACHE 1
+#define NANOVG_GL_USE_UNIFORMBUFFER 1
+#define NANOVG_GLES3_IMPLEMENTATION
+#include "deps/nanovg/nanovg.h"
+#include "deps/nanovg/nanovg_gl.h"
+#pragma GCC diagnostic pop
@@ -0,0 +1,290 @@
+#include <engine/Painter.hpp>
+#include <engine/Script.hpp>
+#include <engine/Engine.hpp>
+
+using namespace std;
+using namespace glm;
+
+Script::Script() : _position(0.f), _delta(0.f), _watch(FileWatcher::Invalid)
+{
+	_lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::string, sol::lib::table);
+
+	bind_glm();
+	bind_painter();
+
+	_lua.new_enum("MouseButton",
+				  "Left", MouseButton::Left,
+				  "Middle", MouseButton::Middle,
+				  "Right", MouseButton::Right,
+				  "X1", MouseButton::X1,
+				  "X2", MouseButton::X2);
+
+	_lua.set_function("log", [](string const& message) { INFO("Script => {}", message); });
+
+	_position_ref = sol::make_object(_lua.lua_state(), &_position);
+	_delta_ref = sol::make_object(_lua.lua_state(), &_delta);
+}
+
+Script::~Script()
+{
+	if(_watch != FileWatcher::Invalid)
+		Engine::ref().files().unwatch(_watch);
+}
+
+void Script::bind_glm()
+{
+	// Plain members, sol reads and writes them in place in the userdata
+	_lua.new_usertype<vec2>("vec2",
+							sol::constructors<sol::types<>, sol::types<float>, sol::types<float, float>>(),
+							"x", &vec2::x,
+							"y", &vec2::y,
+							sol::meta_function::addition, [](vec2 const& a, vec2 const& b) { return a + b; },
+							sol::meta_function::subtraction, [](vec2 const& a, vec2 const& b) { return a - b; },
+							sol::meta_function::multiplication, [](vec2 const& a, float s) { return a * s; },
+							sol::meta_function::equal_to, [](vec2 const& a, vec2 const& b) { return a == b; },
+							"length", [](vec2 const& v) { return length(v); });
+
+	_lua.new_usertype<vec4>("vec4",
+							sol::constructors<sol::types<>, sol::types<float>, sol::types<float, float, float, float>>(),
+							"x", &vec4::x,
+							"y", &vec4::y,
+							"z", &vec4::z,
+							"w", &vec4::w,
+							sol::meta_function::equal_to, [](vec4 const& a, vec4 const& b) { return a == b; });
+
+	// Colors are vec4 too, rgba(1, 0, 0) reads better in scripts
+	_lua.set_function("rgba", [](float r, float g, float b, sol::optional<float> a) { return vec4{r, g, b, a ? *a : 1.f}; });
+}
+
+void Script::bind_painter()
+{
+	_lua.new_enum("Align",
+				  "Left", Align::Left,
+				  "Center", Align::Center,
+				  "Right", Align::Right,
+				  "Top", Align::Top,
+				  "Middle", Align::Middle,
+				  "Bottom", Align::Bottom,
+				  "Baseline", Align::Baseline);
+
+	_lua.new_enum("LineCap",
+				  "Butt", LineCap::Butt,
+				  "Round", LineCap::Round,
+				  "Square", LineCap::Square,
+				  "Bevel", LineCap::Bevel,
+				  "Miter", LineCap::Miter);
+
+	_lua.new_enum("Winding",
+				  "CCW", Winding::CCW,
+				  "CW", Winding::CW);
+
+	_lua.new_usertype<Paint>("Paint", "new", sol::no_constructor);
+
+	// Every call taking vectors also takes plain numbers, the overload is picked from the argument count
+	_lua.new_usertype<Painter>("Painter", "new", sol::no_constructor,
+		"save", &Painter::save,
+		"restore", &Painter::restore,
+		"reset", &Painter::reset,
+		"stroke_color", sol::overload(&Painter::stroke_color,
+									  [](Painter& p, float r, float g, float b, float a) { p.stroke_color({r, g, b, a}); }),
+		"fill_color", sol::overload(&Painter::fill_color,
+									[](Painter& p, float r, float g, float b, float a) { p.fill_color({r, g, b, a}); }),
+		"stroke_paint", &Painter::stroke_paint,
+		"fill_paint", &Painter::fill_paint,
+		"miter_limit", &Painter::miter_limit,
+		"stroke_width", &Painter::stroke_width,
+		"line_cap", &Painter::line_cap,
+		"line_join", &Painter::line_join,
+		"global_alpha", &Painter::global_alpha,
+		"reset_transform", &Painter::reset_transform,
+		"translate", sol::overload(&Painter::translate,
+								   [](Painter& p, float x, float y) { p.translate({x, y}); }),
+		"rotate", &Painter::rotate,
+		"skew_x", &Painter::skew_x,
+		"skew_y", &Painter::skew_y,
+		"scale", sol::overload(&Painter::scale,
+							   [](Painter& p, float x, float y) { p.scale({x, y}); }),
+		"scissor", sol::overload(&Painter::scissor,
+								 [](Painter& p, float x, float y, float w, float h) { p.scissor({x, y}, {w, h}); }),
+		"intersect_scissor", &Painter::intersect_scissor,
+		"reset_scissor", &Painter::reset_scissor,
+		"begin_path", &Painter::begin_path,
+		"move_to", sol::overload(&Painter::move_to,
+								 [](Painter& p, float x, float y) { p.move_to({x, y}); }),
+		"line_to", sol::overload(&Painter::line_to,
+								 [](Painter& p, float x, float y) { p.line_to({x, y}); }),
+		"bezier_to", &Painter::bezier_to,
+		"quad_to", &Painter::quad_to,
+		"arc_to", &Painter::arc_to,
+		"close_path", &Painter::close_path,
+		"path_winding", &Painter::path_winding,
+		"arc", &Painter::arc,
+		"rect", sol::overload(&Painter::rect,
+							  [](Painter& p, float x, float y, float w, float h) { p.rect({x, y}, {w, h}); }),
+		"rounded_rect", sol::overload(&Painter::rounded_rect,
+									  [](Painter& p, float x, float y, float w, float h, float r) { p.rounded_rect({x, y}, {w, h}, r); }),
+		"ellipse", sol::overload(&Painter::ellipse,
+								 [](Painter& p, float x, float y, float rx, float ry) { p.ellipse({x, y}, {rx, ry}); }),
+		"circle", sol::overload(&Painter::circle,
+								[](Painter& p, float x, float y, float r) { p.circle({x, y}, r); }),
+		"fill", &Painter::fill,
+		"stroke", &Painter::stroke,
+		"create_image", [](Painter& p, string const& file, int flags) { return p.create_image(file, static_cast<ImageFlags>(flags)); },
+		"image_size", [](Painter& p, int id) { return vec2(p.image_size(id)); },
+		"delete_image", &Painter::delete_image,
+		"create_font", sol::resolve<int(string const&, string const&)>(&Painter::create_font),
+		"find_font", &Painter::find_font,
+		"font_size", &Painter::font_size,
+		"font_blur", &Painter::font_blur,
+		"text_letter_spacing", &Painter::text_letter_spacing,
+		"text_line_height", &Painter::text_line_height,
+		"text_align", [](Painter& p, int align) { p.text_align(static_cast<Align>(align)); },
+		"font_face", sol::overload(sol::resolve<void(int)>(&Painter::font_face),
+								   sol::resolve<void(string const&)>(&Painter::font_face)),
+		"text", sol::overload(&Painter::text,
+							  [](Painter& p, float x, float y, string const& str) { return p.text({x, y}, str); }),
+		"text_box", &Painter::text_box,
+		"linear_gradient", &Painter::linear_gradient,
+		"box_gradient", &Painter::box_gradien,
+		"radial_gradient", &Painter::radial_gradient,
+		"image_pattern", &Painter::image_pattern);
+}
+
+void Script::bind(Painter* painter)
+{
+	if(painter)
+		_lua["painter"] = painter;
+	else
+		_lua["painter"] = sol::nil;
+}
+
+bool Script::load(filesystem::Path const& file)
+{
+	auto chunk = _lua.load_file(file.str());
+	if(!chunk.valid())
+	{
+		sol::error err = chunk;
+		ERR("Script::load => {}", err.what());
+		return false;
+	}
+
+	sol::protected_function body = chunk;
+	auto result = body();
+	if(!result.valid())
+	{
+		sol::error err = result;
+		ERR("Script::load => {}", err.what());
+		return false;
+	}
+	fetch_callbacks();
+
+	if(_watch == FileWatcher::Invalid || _file.str() != file.str())
+	{
+		auto& files = Engine::ref().files();
+		if(_watch != FileWatcher::Invalid)
+			files.unwatch(_watch);
+		_file = file;
+		_watch = files.watch(file, [this](filesystem::Path const& changed)
+		{
+			INFO("Script::load => Reloading {}", changed.str());
+			load(changed);
+		});
+	}
+
+	DEBUG("Script::load => Loaded {}", file.str());
+	return true;
+}
+
+bool Script::run(string const& code, string const& name)
+{
+	auto chunk = _lua.load_buffer(code.data(), code.size(), name.c_str());
+	if(!chunk.valid())
+	{
+		sol::error err = chunk;
+		ERR("Script::run => {}", err.what());
+		return false;
+	}
+
+	sol::protected_function body = chunk;
+	auto result = body();
+	if(!result.valid())
+	{
+		sol::error err = result;
+		ERR("Script::run => {}", err.what());
+		return false;
+	}
+	fetch_callbacks();
+	return true;
+}
+
+void Script::fetch_callbacks()
+{
+	// Looked up once per load instead of once per call
+	auto fetch = [this](char const* name)
+	{
+		sol::object value = _lua[name];
+		return value.get_type() == sol::type::function ? value.as<sol::protected_function>() : sol::protected_function{};
+	};
+	_update = fetch("update");
+	_frame = fetch("frame");
+	_mouse_button = fetch("mouse_button");
+	_mouse_move = fetch("mouse_move");
+	_scroll = fetch("scroll");
+	_keyboard = fetch("keyboard");
+	_character = fetch("character");
+}
+
+template<typename... Args>
+void Script::call(sol::protected_function& function, char const* name, Args&& ... args)
+{
+	if(!function.valid())
+		return;
+
+	auto result = function(std::forward<Args>(args)...);
+	if(!result.valid())
+	{
+		sol::error err = result;
+		ERR("Script::{} => {}", name, err.what());
+
+		// A broken callback would log every frame, drop it until the next load
+		function = sol::protected_function{};
+	}
+}
+
+void Script::update(Duration dT)
+{
+	call(_update, "update", as_seconds(dT));
+}
+
+void Script::frame()
+{
+	call(_frame, "frame");
+}
+
+void Script::mouse_button(ivec2 const& pos, MouseButton button, bool pressed)
+{
+	_position = vec2(pos);
+	call(_mouse_button, "mouse_button", _position_ref, button, pressed);
+}
+
+void Script::mouse_move(ivec2 const& delta)
+{
+	_delta = vec2(delta);
+	call(_mouse_move, "mouse_move", _delta_ref);
+}
+
+void Script::scroll(ivec2 const& delta)
+{
+	_delta = vec2(delta);
+	call(_scroll, "scroll", _delta_ref);
+}
+
+void Script::keyboard(Key key, bool pressed)
+{
+	call(_keyboard, "keyboard", static_cast<int>(key), pressed);
+}
+
+void Script::character(char const* text)
+{
+	call(_character, "character", text);
+}
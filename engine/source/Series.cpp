@@ -0,0 +1,101 @@
+#include <engine/Series.hpp>
+
+#include <algorithm>
+
+using namespace std;
+using namespace glm;
+
+namespace
+{
+	inline void merge(Series::Node& node, Series::Node const& other)
+	{
+		if(other.low.y < node.low.y)
+			node.low = other.low;
+		if(other.high.y > node.high.y)
+			node.high = other.high;
+		node.last = other.last;
+	}
+}
+
+Series::Series()
+{ }
+
+Series::Series(vector<vec2> points) : _points(move(points))
+{
+	grow();
+}
+
+void Series::append(vec2 const& point)
+{
+	size_t index = _points.size();
+	_points.push_back(point);
+
+	Node single{point, point, point, point};
+	for(size_t l = 0; l < _levels.size(); ++l)
+	{
+		auto& level = _levels[l];
+		if(index % span(l) == 0)
+			level.push_back(single);
+		else
+			merge(level.back(), single);
+	}
+	grow();
+}
+
+void Series::append(vec2 const* points, size_t count)
+{
+	_points.reserve(_points.size() + count);
+	for(size_t i = 0; i < count; ++i)
+		append(points[i]);
+}
+
+void Series::clear()
+{
+	_points.clear();
+	_levels.clear();
+}
+
+size_t Series::span(size_t level)
+{
+	size_t ret = Fanout;
+	for(size_t l = 0; l < level; ++l)
+		ret *= Fanout;
+	return ret;
+}
+
+size_t Series::lower_bound(float x) const
+{
+	return (size_t) (std::lower_bound(_points.begin(), _points.end(), x, [](vec2 const& p, float v) { return p.x < v; }) - _points.begin());
+}
+
+void Series::grow()
+{
+	// A new level once the top one has more than one node, built from it. Builds the whole pyramid of a new series.
+	while(_points.size() > span(_levels.size()))
+	{
+		size_t l = _levels.size();
+		vector<Node> level;
+		if(l == 0)
+		{
+			for(size_t i = 0; i < _points.size(); i += Fanout)
+			{
+				Node node{_points[i], _points[i], _points[i], _points[i]};
+				for(size_t j = i + 1; j < std::min(i + Fanout, _points.size()); ++j)
+					merge(node, {_points[j], _points[j], _points[j], _points[j]});
+				level.push_back(node);
+			}
+		}
+		else
+		{
+			auto const& below = _levels[l - 1];
+			for(size_t i = 0; i < below.size(); i += Fanout)
+			{
+				Node node = below[i];
+				for(size_t j = i + 1; j < std::min(i + Fanout, below.size()); ++j)
+					merge(node, below[j]);
+				level.push_back(node);
+			}
+		}
+		_levels.push_back(move(level));
+	}
+}
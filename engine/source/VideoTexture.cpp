@@ -0,0 +1,215 @@
+#include <engine/VideoTexture.hpp>
+#include <engine/GLState.hpp>
+#include <engine/Engine.hpp>
+#include <glad/glad_es3.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// Core GLES2, missing from the generated loader
+#ifndef GL_LUMINANCE_ALPHA
+#define GL_LUMINANCE_ALPHA 0x190A
+#endif
+
+using namespace std;
+using namespace glm;
+
+namespace
+{
+	const char* ConvertVertex = R"(
+attribute vec2 a_position;
+varying vec2 v_uv;
+void main()
+{
+	v_uv = a_position * 0.5 + 0.5;
+	gl_Position = vec4(a_position, 0.0, 1.0);
+}
+)";
+
+	// Row 0 of the planes lands in row 0 of the target, which is the top row for nanovg like any other image
+	const char* ConvertFragment = R"(
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+uniform sampler2D u_y;
+uniform sampler2D u_u;
+uniform sampler2D u_v;
+uniform vec3 u_offset;
+uniform mat3 u_matrix;
+varying vec2 v_uv;
+void main()
+{
+	float y = texture2D(u_y, v_uv).r;
+#ifdef NV12
+	vec2 uv = texture2D(u_u, v_uv).ra;
+#else
+	vec2 uv = vec2(texture2D(u_u, v_uv).r, texture2D(u_v, v_uv).r);
+#endif
+	gl_FragColor = vec4(u_matrix * (vec3(y, uv) - u_offset), 1.0);
+}
+)";
+
+	const GLfloat Triangle[6]{-1.f, -1.f, 3.f, -1.f, -1.f, 3.f};
+
+	const GLenum SavedCaps[5]{GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND, GL_STENCIL_TEST, GL_SCISSOR_TEST};
+
+	// BT.601, columns are the contributions of Y, U and V to RGB
+	const GLfloat LimitedMatrix[9]{1.164f, 1.164f, 1.164f, 0.f, -0.392f, 2.017f, 1.596f, -0.813f, 0.f};
+	const GLfloat LimitedOffset[3]{16.f / 255.f, 0.5f, 0.5f};
+	const GLfloat FullMatrix[9]{1.f, 1.f, 1.f, 0.f, -0.344f, 1.772f, 1.402f, -0.714f, 0.f};
+	const GLfloat FullOffset[3]{0.f, 0.5f, 0.5f};
+
+	inline int plane_count(PlaneFormat format)
+	{ return format == PlaneFormat::NV12 ? 2 : 3; }
+}
+
+VideoTexture::VideoTexture() :
+		_size(0), _format(PlaneFormat::NV12), _full_range(false), _framebuffer(0), _color(0), _planes{}, _offset_location(-1),
+		_matrix_location(-1)
+{ }
+
+VideoTexture::~VideoTexture()
+{
+	destroy();
+}
+
+void VideoTexture::create(ivec2 const& size, PlaneFormat format)
+{
+	destroy();
+	if(size.x <= 0 || size.y <= 0)
+		throw runtime_error("VideoTexture::create => Empty frame size");
+
+	_format = format;
+	_program.build(ConvertVertex, format == PlaneFormat::NV12 ? string{"#define NV12\n"} + ConvertFragment : ConvertFragment, {{0, "a_position"}});
+	_offset_location = _program.uniform_location("u_offset");
+	_matrix_location = _program.uniform_location("u_matrix");
+	_program.use();
+	glUniform1i(_program.uniform_location("u_y"), 0);
+	glUniform1i(_program.uniform_location("u_u"), 1);
+	if(format == PlaneFormat::I420)
+		glUniform1i(_program.uniform_location("u_v"), 2);
+
+	// Luminance formats rather than R8/RG8, GLES2 has them without EXT_texture_rg
+	GLState::active_texture(GL_TEXTURE0);
+	glGenTextures(plane_count(format), _planes);
+	for(int i = 0; i < plane_count(format); ++i)
+	{
+		ivec2 plane = i == 0 ? size : (size + 1) / 2;
+		GLenum layout = i == 1 && format == PlaneFormat::NV12 ? GL_LUMINANCE_ALPHA : GL_LUMINANCE;
+		GLState::bind_texture(GL_TEXTURE_2D, _planes[i]);
+		glTexImage2D(GL_TEXTURE_2D, 0, layout, plane.x, plane.y, 0, layout, GL_UNSIGNED_BYTE, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	glGenTextures(1, &_color);
+	GLState::bind_texture(GL_TEXTURE_2D, _color);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	GLint previous = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+	glGenFramebuffers(1, &_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _color, 0);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, (GLuint) previous);
+	if(status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		destroy();
+		throw runtime_error("VideoTexture::create => Incomplete framebuffer, status " + to_string(status));
+	}
+
+	_size = size;
+	DEBUG("VideoTexture::create => {}x{} {}", size.x, size.y, format == PlaneFormat::NV12 ? "NV12" : "I420");
+}
+
+void VideoTexture::destroy()
+{
+	if(_framebuffer != 0)
+		glDeleteFramebuffers(1, &_framebuffer);
+	if(_color != 0)
+		GLState::delete_textures(1, &_color);
+	for(auto& plane : _planes)
+		if(plane != 0)
+			GLState::delete_textures(1, &plane);
+	_framebuffer = _color = 0;
+	fill(begin(_planes), end(_planes), 0u);
+	_size = ivec2(0);
+	_program.destroy();
+}
+
+void VideoTexture::update(unsigned char const* const* planes, int const* strides)
+{
+	if(_framebuffer == 0)
+		return;
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for(int i = 0; i < plane_count(_format); ++i)
+	{
+		GLState::active_texture(GL_TEXTURE0 + i);
+		upload(i, planes[i], strides ? strides[i] : 0);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	GLint previous = 0;
+	GLint viewport[4];
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+	glViewport(0, 0, _size.x, _size.y);
+
+	bool saved[5];
+	for(int i = 0; i < 5; ++i)
+	{
+		saved[i] = GLState::enabled(SavedCaps[i]);
+		GLState::disable(SavedCaps[i]);
+	}
+	GLState::color_mask(true, true, true, true);
+
+	_program.use();
+	glUniform3fv(_offset_location, 1, _full_range ? FullOffset : LimitedOffset);
+	glUniformMatrix3fv(_matrix_location, 1, GL_FALSE, _full_range ? FullMatrix : LimitedMatrix);
+	GLState::bind_vertex_array(0);
+	GLState::bind_buffer(GL_ARRAY_BUFFER, 0);
+	GLState::enable_attributes(1u);
+	GLState::attribute_pointer(0, 2, GL_FLOAT, false, 0, Triangle);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+
+	for(int i = 0; i < 5; ++i)
+		GLState::enable(SavedCaps[i], saved[i]);
+	GLState::active_texture(GL_TEXTURE0);
+	glBindFramebuffer(GL_FRAMEBUFFER, (GLuint) previous);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void VideoTexture::upload(int plane, unsigned char const* data, int stride)
+{
+	ivec2 size = plane == 0 ? _size : (_size + 1) / 2;
+	int channels = plane == 1 && _format == PlaneFormat::NV12 ? 2 : 1;
+	GLenum layout = channels == 2 ? GL_LUMINANCE_ALPHA : GL_LUMINANCE;
+
+	GLState::bind_texture(GL_TEXTURE_2D, _planes[plane]);
+	if(stride <= 0 || stride == size.x * channels)
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.x, size.y, layout, GL_UNSIGNED_BYTE, data);
+	else if((GLAD_GL_ES_VERSION_3_0 || GLAD_GL_EXT_unpack_subimage) && stride % channels == 0)
+	{
+		// Same value as GL_UNPACK_ROW_LENGTH of GLES3
+		glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, stride / channels);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.x, size.y, layout, GL_UNSIGNED_BYTE, data);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0);
+	}
+	else
+	{
+		for(int y = 0; y < size.y; ++y)
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, size.x, 1, layout, GL_UNSIGNED_BYTE, data + (size_t) y * stride);
+	}
+}
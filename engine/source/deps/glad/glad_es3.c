@@ -0,0 +1,38 @@
+#include <stddef.h>
+#include <glad/glad_es3.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+int GLAD_GL_ES_VERSION_3_0;
+
+PFNGLBINDVERTEXARRAYPROC glad_glBindVertexArray;
+PFNGLDELETEVERTEXARRAYSPROC glad_glDeleteVertexArrays;
+PFNGLGENVERTEXARRAYSPROC glad_glGenVertexArrays;
+PFNGLBINDBUFFERRANGEPROC glad_glBindBufferRange;
+PFNGLGETUNIFORMBLOCKINDEXPROC glad_glGetUniformBlockIndex;
+PFNGLUNIFORMBLOCKBINDINGPROC glad_glUniformBlockBinding;
+PFNGLBLITFRAMEBUFFERPROC glad_glBlitFramebuffer;
+PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC glad_glRenderbufferStorageMultisample;
+
+int gladLoadGLES3Loader(GLADloadproc load) {
+	GLAD_GL_ES_VERSION_3_0 = 0;
+	if(GLVersion.major < 3) return 0;
+
+	glad_glBindVertexArray = (PFNGLBINDVERTEXARRAYPROC)load("glBindVertexArray");
+	glad_glDeleteVertexArrays = (PFNGLDELETEVERTEXARRAYSPROC)load("glDeleteVertexArrays");
+	glad_glGenVertexArrays = (PFNGLGENVERTEXARRAYSPROC)load("glGenVertexArrays");
+	glad_glBindBufferRange = (PFNGLBINDBUFFERRANGEPROC)load("glBindBufferRange");
+	glad_glGetUniformBlockIndex = (PFNGLGETUNIFORMBLOCKINDEXPROC)load("glGetUniformBlockIndex");
+	glad_glUniformBlockBinding = (PFNGLUNIFORMBLOCKBINDINGPROC)load("glUniformBlockBinding");
+	glad_glBlitFramebuffer = (PFNGLBLITFRAMEBUFFERPROC)load("glBlitFramebuffer");
+	glad_glRenderbufferStorageMultisample = (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC)load("glRenderbufferStorageMultisample");
+
+	/* Some drivers report 3.0 and leave entry points out, treat that as ES 2.0 */
+	GLAD_GL_ES_VERSION_3_0 = glad_glBindVertexArray && glad_glDeleteVertexArrays && glad_glGenVertexArrays &&
+		glad_glBindBufferRange && glad_glGetUniformBlockIndex && glad_glUniformBlockBinding &&
+		glad_glBlitFramebuffer && glad_glRenderbufferStorageMultisample;
+	return GLAD_GL_ES_VERSION_3_0;
+}
+
+#pragma GCC diagnostic pop
@@ -98,6 +98,8 @@ int fonsResetAtlas(FONScontext* stash, int width, int height);
 // Add fonts
 int fonsAddFont(FONScontext* s, const char* name, const char* path);
 int fonsAddFontMem(FONScontext* s, const char* name, unsigned char* data, int ndata, int freeData);
+// Swaps the data of a font in place, returns 0 and leaves the font untouched if data cannot be loaded.
+int fonsReplaceFontMem(FONScontext* s, int font, unsigned char* data, int ndata, int freeData);
 int fonsGetFontByName(FONScontext* s, const char* name);
 
 // State handling
@@ -475,7 +477,15 @@ static unsigned int fons__decutf8(unsigned int* state, unsigned int* codep, unsi
 		12,36,12,12,12,12,12,12,12,12,12,12,
     };
 
-	unsigned int type = utf8d[byte];
+	unsigned int type;
+
+	// ASCII outside of a multi-byte sequence is its own codepoint, no table lookups
+	if (byte < 0x80 && *state == FONS_UTF8_ACCEPT) {
+		*codep = byte;
+		return FONS_UTF8_ACCEPT;
+	}
+
+	type = utf8d[byte];
 
     *codep = (*state != FONS_UTF8_ACCEPT) ?
 		(byte & 0x3fu) | (*codep << 6) :
@@ -918,6 +928,41 @@ error:
 	return FONS_INVALID;
 }
 
+int fonsReplaceFontMem(FONScontext* stash, int idx, unsigned char* data, int dataSize, int freeData)
+{
+	int i, ascent, descent, fh, lineGap;
+	FONSfont* font;
+	FONSttFontImpl impl;
+
+	if (idx < 0 || idx >= stash->nfonts)
+		return 0;
+	font = stash->fonts[idx];
+
+	stash->nscratch = 0;
+	if (!fons__tt_loadFont(stash, &impl, data, dataSize))
+		return 0;
+
+	if (font->freeData && font->data)
+		free(font->data);
+	font->font = impl;
+	font->dataSize = dataSize;
+	font->data = data;
+	font->freeData = (unsigned char)freeData;
+
+	// Forget the cached glyphs, their atlas space is simply not reused
+	font->nglyphs = 0;
+	for (i = 0; i < FONS_HASH_LUT_SIZE; ++i)
+		font->lut[i] = -1;
+
+	fons__tt_getFontVMetrics( &font->font, &ascent, &descent, &lineGap);
+	fh = ascent - descent;
+	font->ascender = (float)ascent / (float)fh;
+	font->descender = (float)descent / (float)fh;
+	font->lineh = (float)(fh + lineGap) / (float)fh;
+
+	return 1;
+}
+
 int fonsGetFontByName(FONScontext* s, const char* name)
 {
 	int i;
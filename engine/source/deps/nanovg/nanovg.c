@@ -53,6 +53,22 @@
 #define NVG_COUNTOF(arr) (sizeof(arr) / sizeof(0[arr]))
 
 
+// The NEON path has not been checked against the scalar one on ARM yet, ARM builds use the scalar loop unless
+// NVG_USE_NEON is defined.
+#if defined(NVG_USE_NEON) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define NVG_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NVG_SSE 1
+#endif
+
+#ifdef _MSC_VER
+#define NVG_RESTRICT __restrict
+#else
+#define NVG_RESTRICT __restrict__
+#endif
+
 enum NVGcommands {
 	NVG_MOVETO = 0,
 	NVG_LINETO = 1,
@@ -131,6 +147,7 @@ struct NVGcontext {
 	int fillTriCount;
 	int strokeTriCount;
 	int textTriCount;
+	int vertCount;
 };
 
 static float nvg__sqrtf(float a) { return sqrtf(a); }
@@ -305,6 +322,7 @@ void nvgBeginFrame(NVGcontext* ctx, int windowWidth, int windowHeight, float dev
 	ctx->fillTriCount = 0;
 	ctx->strokeTriCount = 0;
 	ctx->textTriCount = 0;
+	ctx->vertCount = 0;
 }
 
 void nvgCancelFrame(NVGcontext* ctx)
@@ -312,6 +330,13 @@ void nvgCancelFrame(NVGcontext* ctx)
 	ctx->params.renderCancel(ctx->params.userPtr);
 }
 
+void nvgFrameStats(NVGcontext* ctx, NVGframeStats* stats)
+{
+	stats->drawCalls = ctx->drawCallCount;
+	stats->triangles = ctx->fillTriCount + ctx->strokeTriCount + ctx->textTriCount;
+	stats->vertices = ctx->vertCount;
+}
+
 void nvgEndFrame(NVGcontext* ctx)
 {
 	ctx->params.renderFlush(ctx->params.userPtr);
@@ -751,6 +776,34 @@ void nvgUpdateImage(NVGcontext* ctx, int image, const unsigned char* data)
 	ctx->params.renderUpdateTexture(ctx->params.userPtr, image, 0,0, w,h, data);
 }
 
+void nvgUpdateImageRegion(NVGcontext* ctx, int image, int x, int y, int w, int h, const unsigned char* data)
+{
+	int iw, ih;
+	if (ctx->params.renderGetTextureSize(ctx->params.userPtr, image, &iw, &ih) == 0) return;
+	if (x < 0) { w += x; x = 0; }
+	if (y < 0) { h += y; y = 0; }
+	w = nvg__mini(w, iw - x);
+	h = nvg__mini(h, ih - y);
+	if (w <= 0 || h <= 0) return;
+	ctx->params.renderUpdateTexture(ctx->params.userPtr, image, x,y, w,h, data);
+}
+
+int nvgReloadImageMem(NVGcontext* ctx, int image, const unsigned char* data, int ndata)
+{
+	int w, h, n, cw, ch;
+	unsigned char* img = stbi_load_from_memory(data, ndata, &w, &h, &n, 4);
+	if (img == NULL)
+		return 0;
+	ctx->params.renderGetTextureSize(ctx->params.userPtr, image, &cw, &ch);
+	if (w != cw || h != ch) {
+		stbi_image_free(img);
+		return 0;
+	}
+	ctx->params.renderUpdateTexture(ctx->params.userPtr, image, 0,0, w,h, img);
+	stbi_image_free(img);
+	return 1;
+}
+
 void nvgImageSize(NVGcontext* ctx, int image, int* w, int* h)
 {
 	ctx->params.renderGetTextureSize(ctx->params.userPtr, image, w, h);
@@ -967,19 +1020,25 @@ static float nvg__distPtSeg(float x, float y, float px, float py, float qx, floa
 	return dx*dx + dy*dy;
 }
 
-static void nvg__appendCommands(NVGcontext* ctx, float* vals, int nvals)
+static int nvg__reserveCommands(NVGcontext* ctx, int nvals)
 {
-	NVGstate* state = nvg__getState(ctx);
-	int i;
-
 	if (ctx->ncommands+nvals > ctx->ccommands) {
 		float* commands;
 		int ccommands = ctx->ncommands+nvals + ctx->ccommands/2;
 		commands = (float*)realloc(ctx->commands, sizeof(float)*ccommands);
-		if (commands == NULL) return;
+		if (commands == NULL) return 0;
 		ctx->commands = commands;
 		ctx->ccommands = ccommands;
 	}
+	return 1;
+}
+
+static void nvg__appendCommands(NVGcontext* ctx, float* vals, int nvals)
+{
+	NVGstate* state = nvg__getState(ctx);
+	int i;
+
+	if (!nvg__reserveCommands(ctx, nvals)) return;
 
 	if ((int)vals[0] != NVG_CLOSE && (int)vals[0] != NVG_WINDING) {
 		ctx->commandx = vals[nvals-2];
@@ -1865,6 +1924,108 @@ void nvgLineTo(NVGcontext* ctx, float x, float y)
 	nvg__appendCommands(ctx, vals, NVG_COUNTOF(vals));
 }
 
+// Writes each point as a command followed by the transformed point, four points at a time with NEON
+// (deinterleaving loads and interleaving stores, opt-in through NVG_USE_NEON) and two at a time with SSE.
+static void nvg__transformCommands(float* NVG_RESTRICT dst, const float* NVG_RESTRICT src, int npoints, float cmd, const float* t)
+{
+	float a = t[0], b = t[1], c = t[2], d = t[3], e = t[4], f = t[5];
+	int i = 0;
+#if NVG_NEON
+	float32x4_t va = vdupq_n_f32(a), vb = vdupq_n_f32(b), vc = vdupq_n_f32(c), vd = vdupq_n_f32(d);
+	float32x4_t ve = vdupq_n_f32(e), vf = vdupq_n_f32(f);
+	float32x4x3_t out;
+	out.val[0] = vdupq_n_f32(cmd);
+	for (; i + 4 <= npoints; i += 4) {
+		float32x4x2_t p = vld2q_f32(&src[i*2]);
+		// Separate multiplies and adds rather than vmlaq_f32, which may become a fused fmla, (x*a + y*c) + e
+		out.val[1] = vaddq_f32(vaddq_f32(vmulq_f32(p.val[0], va), vmulq_f32(p.val[1], vc)), ve);
+		out.val[2] = vaddq_f32(vaddq_f32(vmulq_f32(p.val[0], vb), vmulq_f32(p.val[1], vd)), vf);
+		vst3q_f32(&dst[i*3], out);
+	}
+#elif NVG_SSE
+	__m128 m0 = _mm_setr_ps(a, b, a, b), m1 = _mm_setr_ps(c, d, c, d), m2 = _mm_setr_ps(e, f, e, f);
+	for (; i + 2 <= npoints; i += 2) {
+		__m128 p = _mm_loadu_ps(&src[i*2]);
+		__m128 xs = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 ys = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, m0), _mm_mul_ps(ys, m1)), m2);
+		dst[i*3] = cmd;
+		_mm_storel_pi((__m64*)&dst[i*3+1], r);
+		dst[i*3+3] = cmd;
+		_mm_storeh_pi((__m64*)&dst[i*3+4], r);
+	}
+#endif
+	for (; i < npoints; i++) {
+		float x = src[i*2], y = src[i*2+1];
+		dst[i*3] = cmd;
+		dst[i*3+1] = x*a + y*c + e;
+		dst[i*3+2] = x*b + y*d + f;
+	}
+}
+
+void nvgLineStrip(NVGcontext* ctx, const float* points, int npoints)
+{
+	NVGstate* state = nvg__getState(ctx);
+	float* dst;
+
+	if (npoints <= 0) return;
+	if (!nvg__reserveCommands(ctx, npoints*3)) return;
+
+	dst = &ctx->commands[ctx->ncommands];
+	nvg__transformCommands(dst, points, 1, NVG_MOVETO, state->xform);
+	nvg__transformCommands(dst+3, points+2, npoints-1, NVG_LINETO, state->xform);
+	ctx->ncommands += npoints*3;
+	ctx->commandx = points[npoints*2-2];
+	ctx->commandy = points[npoints*2-1];
+}
+
+void nvgAppendPath(NVGcontext* ctx, const unsigned char* commands, int ncommands, const float* points, int npoints)
+{
+	NVGstate* state = nvg__getState(ctx);
+	const float* t = state->xform;
+	int i, nvals = 0, used = 0, p = 0;
+	float* dst;
+
+	// Sized up front, the buffer grows once for the whole path
+	for (i = 0; i < ncommands; i++) {
+		int n = commands[i] == NVG_PATH_BEZIERTO ? 3 : commands[i] == NVG_PATH_CLOSE ? 0 : 1;
+		if (commands[i] > NVG_PATH_CLOSE || used + n > npoints) break;
+		used += n;
+		nvals += 1 + n*2;
+	}
+	ncommands = i;
+	if (nvals == 0) return;
+	if (!nvg__reserveCommands(ctx, nvals)) return;
+
+	dst = &ctx->commands[ctx->ncommands];
+	for (i = 0; i < ncommands; i++) {
+		switch (commands[i]) {
+		case NVG_PATH_MOVETO:
+		case NVG_PATH_LINETO:
+			nvg__transformCommands(dst, &points[p*2], 1, commands[i] == NVG_PATH_MOVETO ? NVG_MOVETO : NVG_LINETO, t);
+			dst += 3;
+			p++;
+			break;
+		case NVG_PATH_BEZIERTO:
+			*dst++ = NVG_BEZIERTO;
+			nvgTransformPoint(&dst[0], &dst[1], t, points[p*2], points[p*2+1]);
+			nvgTransformPoint(&dst[2], &dst[3], t, points[p*2+2], points[p*2+3]);
+			nvgTransformPoint(&dst[4], &dst[5], t, points[p*2+4], points[p*2+5]);
+			dst += 6;
+			p += 3;
+			break;
+		default:
+			*dst++ = NVG_CLOSE;
+			break;
+		}
+	}
+	ctx->ncommands += nvals;
+	if (p > 0) {
+		ctx->commandx = points[p*2-2];
+		ctx->commandy = points[p*2-1];
+	}
+}
+
 void nvgBezierTo(NVGcontext* ctx, float c1x, float c1y, float c2x, float c2y, float x, float y)
 {
 	float vals[] = { NVG_BEZIERTO, c1x, c1y, c2x, c2y, x, y };
@@ -2115,8 +2276,11 @@ void nvgFill(NVGcontext* ctx)
 	for (i = 0; i < ctx->cache->npaths; i++) {
 		path = &ctx->cache->paths[i];
 		ctx->fillTriCount += path->nfill-2;
-		ctx->fillTriCount += path->nstroke-2;
+		// No fringe without antialiasing
+		if (path->nstroke > 0)
+			ctx->fillTriCount += path->nstroke-2;
 		ctx->drawCallCount += 2;
+		ctx->vertCount += path->nfill + path->nstroke;
 	}
 }
 
@@ -2157,6 +2321,7 @@ void nvgStroke(NVGcontext* ctx)
 		path = &ctx->cache->paths[i];
 		ctx->strokeTriCount += path->nstroke-2;
 		ctx->drawCallCount++;
+		ctx->vertCount += path->nstroke;
 	}
 }
 
@@ -2171,6 +2336,11 @@ int nvgCreateFontMem(NVGcontext* ctx, const char* name, unsigned char* data, int
 	return fonsAddFontMem(ctx->fs, name, data, ndata, freeData);
 }
 
+int nvgReplaceFontMem(NVGcontext* ctx, int font, unsigned char* data, int ndata, int freeData)
+{
+	return fonsReplaceFontMem(ctx->fs, font, data, ndata, freeData);
+}
+
 int nvgFindFont(NVGcontext* ctx, const char* name)
 {
 	if (name == NULL) return -1;
@@ -2289,6 +2459,7 @@ static void nvg__renderText(NVGcontext* ctx, NVGvertex* verts, int nverts)
 
 	ctx->drawCallCount++;
 	ctx->textTriCount += nverts/3;
+	ctx->vertCount += nverts;
 }
 
 float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char* end)
@@ -2358,6 +2529,76 @@ float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char*
 	return iter.x;
 }
 
+void nvgTextBatch(NVGcontext* ctx, const NVGtextLabel* labels, int nlabels)
+{
+	NVGstate* state = nvg__getState(ctx);
+	FONStextIter iter, prevIter;
+	FONSquad q;
+	NVGvertex* verts;
+	float scale = nvg__getFontScale(state) * ctx->devicePxRatio;
+	float invscale = 1.0f / scale;
+	int cverts = 0;
+	int nverts = 0;
+	int i;
+
+	if (state->fontId == FONS_INVALID || nlabels <= 0) return;
+
+	fonsSetSize(ctx->fs, state->fontSize*scale);
+	fonsSetSpacing(ctx->fs, state->letterSpacing*scale);
+	fonsSetBlur(ctx->fs, state->fontBlur*scale);
+	fonsSetAlign(ctx->fs, state->textAlign);
+	fonsSetFont(ctx->fs, state->fontId);
+
+	// Room for every label at once, a conservative estimate like nvgText()
+	for (i = 0; i < nlabels; i++) {
+		const char* end = labels[i].end != NULL ? labels[i].end : labels[i].string + strlen(labels[i].string);
+		cverts += (int)(end - labels[i].string) * 6;
+	}
+	verts = nvg__allocTempVerts(ctx, nvg__maxi(cverts, 12));
+	if (verts == NULL) return;
+
+	for (i = 0; i < nlabels; i++) {
+		fonsTextIterInit(ctx->fs, &iter, labels[i].x*scale, labels[i].y*scale, labels[i].string, labels[i].end);
+		prevIter = iter;
+		while (fonsTextIterNext(ctx->fs, &iter, &q)) {
+			float c[4*2];
+			if (iter.prevGlyphIndex == -1) { // can not retrieve glyph?
+				// What was laid out so far uses the current atlas, draw it before moving to the next one
+				if (nverts != 0) {
+					nvg__flushTextTexture(ctx);
+					nvg__renderText(ctx, verts, nverts);
+					nverts = 0;
+				}
+				if (!nvg__allocTextAtlas(ctx))
+					return; // no memory :(
+				iter = prevIter;
+				fonsTextIterNext(ctx->fs, &iter, &q); // try again
+				if (iter.prevGlyphIndex == -1) // still can not find glyph?
+					break;
+			}
+			prevIter = iter;
+			// Transform corners.
+			nvgTransformPoint(&c[0],&c[1], state->xform, q.x0*invscale, q.y0*invscale);
+			nvgTransformPoint(&c[2],&c[3], state->xform, q.x1*invscale, q.y0*invscale);
+			nvgTransformPoint(&c[4],&c[5], state->xform, q.x1*invscale, q.y1*invscale);
+			nvgTransformPoint(&c[6],&c[7], state->xform, q.x0*invscale, q.y1*invscale);
+			// Create triangles
+			if (nverts+6 <= cverts) {
+				nvg__vset(&verts[nverts], c[0], c[1], q.s0, q.t0); nverts++;
+				nvg__vset(&verts[nverts], c[4], c[5], q.s1, q.t1); nverts++;
+				nvg__vset(&verts[nverts], c[2], c[3], q.s1, q.t0); nverts++;
+				nvg__vset(&verts[nverts], c[0], c[1], q.s0, q.t0); nverts++;
+				nvg__vset(&verts[nverts], c[6], c[7], q.s0, q.t1); nverts++;
+				nvg__vset(&verts[nverts], c[4], c[5], q.s1, q.t1); nverts++;
+			}
+		}
+	}
+
+	nvg__flushTextTexture(ctx);
+	if (nverts != 0)
+		nvg__renderText(ctx, verts, nverts);
+}
+
 void nvgTextBox(NVGcontext* ctx, float x, float y, float breakRowWidth, const char* string, const char* end)
 {
 	NVGstate* state = nvg__getState(ctx);
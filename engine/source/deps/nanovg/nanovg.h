@@ -58,6 +58,13 @@ enum NVGwinding {
 	NVG_CW = 2,				// Winding for holes
 };
 
+enum NVGpathCommand {
+	NVG_PATH_MOVETO = 0,
+	NVG_PATH_LINETO = 1,
+	NVG_PATH_BEZIERTO = 2,
+	NVG_PATH_CLOSE = 3,
+};
+
 enum NVGsolidity {
 	NVG_SOLID = 1,			// CCW
 	NVG_HOLE = 2,			// CW
@@ -123,6 +130,16 @@ void nvgCancelFrame(NVGcontext* ctx);
 // Ends drawing flushing remaining render state.
 void nvgEndFrame(NVGcontext* ctx);
 
+// Geometry submitted since nvgBeginFrame(), still valid after nvgEndFrame().
+struct NVGframeStats {
+	int drawCalls;
+	int triangles;
+	int vertices;
+};
+typedef struct NVGframeStats NVGframeStats;
+
+void nvgFrameStats(NVGcontext* ctx, NVGframeStats* stats);
+
 //
 // Color utils
 //
@@ -326,6 +343,14 @@ int nvgCreateImageRGBA(NVGcontext* ctx, int w, int h, int imageFlags, const unsi
 // Updates image data specified by image handle.
 void nvgUpdateImage(NVGcontext* ctx, int image, const unsigned char* data);
 
+// Updates only the rectangle (x,y,w,h) of the image, data still points to the pixels of the whole image.
+// The rectangle is clipped to the image. GLES2 without EXT_unpack_subimage uploads the full rows it covers.
+void nvgUpdateImageRegion(NVGcontext* ctx, int image, int x, int y, int w, int h, const unsigned char* data);
+
+// Decodes the image from memory and updates image data specified by image handle.
+// Returns 0 if the image cannot be decoded or its dimensions changed.
+int nvgReloadImageMem(NVGcontext* ctx, int image, const unsigned char* data, int ndata);
+
 // Returns the dimensions of a created image.
 void nvgImageSize(NVGcontext* ctx, int image, int* w, int* h);
 
@@ -426,6 +451,14 @@ void nvgClosePath(NVGcontext* ctx);
 // Sets the current sub-path winding, see NVGwinding and NVGsolidity. 
 void nvgPathWinding(NVGcontext* ctx, int dir);
 
+// Appends a whole path in one call. Commands are NVGpathCommand values, each takes its points from the array
+// in order: NVG_PATH_MOVETO and NVG_PATH_LINETO one, NVG_PATH_BEZIERTO three (two controls, then the end),
+// NVG_PATH_CLOSE none. Points are x,y pairs, commands left without enough points are dropped.
+void nvgAppendPath(NVGcontext* ctx, const unsigned char* commands, int ncommands, const float* points, int npoints);
+
+// Starts a sub-path at the first x,y pair and adds line segments through the others.
+void nvgLineStrip(NVGcontext* ctx, const float* points, int npoints);
+
 // Creates new circle arc shaped sub-path. The arc center is at cx,cy, the arc radius is r,
 // and the arc is drawn from angle a0 to a1, and swept in direction dir (NVG_CCW, or NVG_CW).
 // Angles are specified in radians.
@@ -491,6 +524,10 @@ int nvgCreateFont(NVGcontext* ctx, const char* name, const char* filename);
 // Returns handle to the font.
 int nvgCreateFontMem(NVGcontext* ctx, const char* name, unsigned char* data, int ndata, int freeData);
 
+// Replaces the data of a font in place, handles and names stay valid.
+// Returns 0 and leaves the font untouched if the data cannot be loaded.
+int nvgReplaceFontMem(NVGcontext* ctx, int font, unsigned char* data, int ndata, int freeData);
+
 // Finds a loaded font of specified name, and returns handle to it, or -1 if the font is not found.
 int nvgFindFont(NVGcontext* ctx, const char* name);
 
@@ -518,6 +555,18 @@ void nvgFontFace(NVGcontext* ctx, const char* font);
 // Draws text string at specified location. If end is specified only the sub-string up to the end is drawn.
 float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char* end);
 
+// A string drawn by nvgTextBatch(). If end is NULL the string is null terminated.
+struct NVGtextLabel {
+	float x, y;
+	const char* string;
+	const char* end;
+};
+typedef struct NVGtextLabel NVGtextLabel;
+
+// Draws many strings sharing the current font and fill paint as one vertex run and one draw call.
+// Each label is aligned on its own like nvgText().
+void nvgTextBatch(NVGcontext* ctx, const NVGtextLabel* labels, int nlabels);
+
 // Draws multi-line text string at specified location wrapped at the specified width. If end is specified only the sub-string up to the end is drawn.
 // White space is stripped at the beginning of the rows, the text is split at word boundaries or when new-line characters are encountered.
 // Words longer than the max width are slit at nearest character (i.e. no hyphenation).
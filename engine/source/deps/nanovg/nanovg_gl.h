@@ -49,7 +49,16 @@ enum NVGcreateFlags {
 #  define NANOVG_GL_IMPLEMENTATION 1
 #endif
 
+// Vertex state lives in a vertex array object on GL3 and GLES3, so it is not respecified on other GL users' state.
+#if defined NANOVG_GL3 || defined NANOVG_GLES3
+#  define NANOVG_GL_USE_VERTEXARRAY 1
+#endif
+
+// Define NANOVG_GL_USE_STATE_CACHE to route every render state change through the engine GLState
+// cache (engine/GLState.hpp) instead of the local texture/stencil filter.
+#if !defined NANOVG_GL_USE_STATE_CACHE
 #define NANOVG_GL_USE_STATE_FILTER (1)
+#endif
 
 // Creates NanoVG contexts for different OpenGL (ES) versions.
 // Flags should be combination of the create flags above.
@@ -113,6 +122,69 @@ enum NVGimageFlagsGL {
 #include <math.h>
 #include "nanovg.h"
 
+#if NANOVG_GL_USE_STATE_CACHE
+#define glnvgEnable(cap)                        GLState::enable(cap, true)
+#define glnvgDisable(cap)                       GLState::enable(cap, false)
+#define glnvgUseProgram(prog)                   GLState::use_program(prog)
+#define glnvgBindBuffer(target, buf)            GLState::bind_buffer(target, buf)
+#define glnvgActiveTexture(unit)                GLState::active_texture(unit)
+#define glnvgBindTexture(target, tex)           GLState::bind_texture(target, tex)
+#define glnvgBlendFunc(src, dst)                GLState::blend_func(src, dst)
+#define glnvgCullFace(mode)                     GLState::cull_face(mode)
+#define glnvgFrontFace(mode)                    GLState::front_face(mode)
+#define glnvgColorMask(r, g, b, a)              GLState::color_mask(r, g, b, a)
+#define glnvgStencilMask(mask)                  GLState::stencil_mask(mask)
+#define glnvgStencilFunc(func, ref, mask)       GLState::stencil_func(func, ref, mask)
+#define glnvgStencilOp(sf, dpf, dpp)            GLState::stencil_op(sf, dpf, dpp)
+#define glnvgStencilOpSeparate(f, sf, dpf, dpp) GLState::stencil_op_separate(f, sf, dpf, dpp)
+#define glnvgEnableVertexAttribArray(i)         GLState::enable_attribute(i, true)
+#define glnvgDisableVertexAttribArray(i)        GLState::enable_attribute(i, false)
+#define glnvgVertexAttribPointer(i, s, t, n, st, p) GLState::attribute_pointer(i, s, t, n, st, p)
+#define glnvgDeleteBuffers(n, bufs)             GLState::delete_buffers(n, bufs)
+#define glnvgDeleteTextures(n, texs)            GLState::delete_textures(n, texs)
+#define glnvgDeleteProgram(prog)                GLState::delete_program(prog)
+#define glnvgBindVertexArray(arr)               GLState::bind_vertex_array(arr)
+#define glnvgDeleteVertexArrays(n, arrs)        GLState::delete_vertex_arrays(n, arrs)
+#else
+#define glnvgEnable                  glEnable
+#define glnvgDisable                 glDisable
+#define glnvgUseProgram              glUseProgram
+#define glnvgBindBuffer              glBindBuffer
+#define glnvgActiveTexture           glActiveTexture
+#define glnvgBindTexture             glBindTexture
+#define glnvgBlendFunc               glBlendFunc
+#define glnvgCullFace                glCullFace
+#define glnvgFrontFace               glFrontFace
+#define glnvgColorMask               glColorMask
+#define glnvgStencilMask             glStencilMask
+#define glnvgStencilFunc             glStencilFunc
+#define glnvgStencilOp               glStencilOp
+#define glnvgStencilOpSeparate       glStencilOpSeparate
+#define glnvgEnableVertexAttribArray glEnableVertexAttribArray
+#define glnvgDisableVertexAttribArray glDisableVertexAttribArray
+#define glnvgVertexAttribPointer     glVertexAttribPointer
+#define glnvgDeleteBuffers           glDeleteBuffers
+#define glnvgDeleteTextures          glDeleteTextures
+#define glnvgDeleteProgram           glDeleteProgram
+#define glnvgBindVertexArray         glBindVertexArray
+#define glnvgDeleteVertexArrays      glDeleteVertexArrays
+#endif
+
+// GLES2 can only skip rows and pixels of the source data with EXT_unpack_subimage, checked at runtime when the
+// GL loader exposes it.
+#if defined NANOVG_GLES2
+#if defined(__glad_h_) && defined(GL_EXT_unpack_subimage)
+#define glnvg__unpackSubimage() GLAD_GL_EXT_unpack_subimage
+#else
+#define glnvg__unpackSubimage() 0
+#ifndef GL_UNPACK_ROW_LENGTH_EXT
+#define GL_UNPACK_ROW_LENGTH_EXT 0x0CF2
+#define GL_UNPACK_SKIP_ROWS_EXT 0x0CF3
+#define GL_UNPACK_SKIP_PIXELS_EXT 0x0CF4
+#endif
+#endif
+#endif
+
 enum GLNVGuniformLoc {
 	GLNVG_LOC_VIEWSIZE,
 	GLNVG_LOC_TEX,
@@ -226,7 +298,7 @@ struct GLNVGcontext {
 	int ctextures;
 	int textureId;
 	GLuint vertBuf;
-#if defined NANOVG_GL3
+#if NANOVG_GL_USE_VERTEXARRAY
 	GLuint vertArr;
 #endif
 #if NANOVG_GL_USE_UNIFORMBUFFER
@@ -284,7 +356,8 @@ static void glnvg__bindTexture(GLNVGcontext* gl, GLuint tex)
 		glBindTexture(GL_TEXTURE_2D, tex);
 	}
 #else
-	glBindTexture(GL_TEXTURE_2D, tex);
+	(void)gl;
+	glnvgBindTexture(GL_TEXTURE_2D, tex);
 #endif
 }
 
@@ -296,7 +369,8 @@ static void glnvg__stencilMask(GLNVGcontext* gl, GLuint mask)
 		glStencilMask(mask);
 	}
 #else
-	glStencilMask(mask);
+	(void)gl;
+	glnvgStencilMask(mask);
 #endif
 }
 
@@ -313,7 +387,8 @@ static void glnvg__stencilFunc(GLNVGcontext* gl, GLenum func, GLint ref, GLuint
 		glStencilFunc(func, ref, mask);
 	}
 #else
-	glStencilFunc(func, ref, mask);
+	(void)gl;
+	glnvgStencilFunc(func, ref, mask);
 #endif
 }
 
@@ -361,7 +436,7 @@ static int glnvg__deleteTexture(GLNVGcontext* gl, int id)
 	for (i = 0; i < gl->ntextures; i++) {
 		if (gl->textures[i].id == id) {
 			if (gl->textures[i].tex != 0 && (gl->textures[i].flags & NVG_IMAGE_NODELETE) == 0)
-				glDeleteTextures(1, &gl->textures[i].tex);
+				glnvgDeleteTextures(1, &gl->textures[i].tex);
 			memset(&gl->textures[i], 0, sizeof(gl->textures[i]));
 			return 1;
 		}
@@ -400,6 +475,16 @@ static void glnvg__checkError(GLNVGcontext* gl, const char* str)
 	}
 }
 
+#if NANOVG_GL_USE_PROGRAM_CACHE
+// glnvgLinkProgram() is provided by the includer, it returns a linked program (possibly loaded from a
+// program binary cache) with "vertex" bound to 0 and "tcoord" to 1, or 0 on failure.
+static int glnvg__createShader(GLNVGshader* shader, const char* name, const char* header, const char* opts, const char* vshader, const char* fshader)
+{
+	memset(shader, 0, sizeof(*shader));
+	shader->prog = glnvgLinkProgram(name, header, opts != NULL ? opts : "", vshader, fshader);
+	return shader->prog != 0;
+}
+#else
 static int glnvg__createShader(GLNVGshader* shader, const char* name, const char* header, const char* opts, const char* vshader, const char* fshader)
 {
 	GLint status;
@@ -451,11 +536,12 @@ static int glnvg__createShader(GLNVGshader* shader, const char* name, const char
 
 	return 1;
 }
+#endif
 
 static void glnvg__deleteShader(GLNVGshader* shader)
 {
 	if (shader->prog != 0)
-		glDeleteProgram(shader->prog);
+		glnvgDeleteProgram(shader->prog);
 	if (shader->vert != 0)
 		glDeleteShader(shader->vert);
 	if (shader->frag != 0)
@@ -663,7 +749,7 @@ static int glnvg__renderCreate(void* uptr)
 	glnvg__getUniforms(&gl->shader);
 
 	// Create dynamic vertex array
-#if defined NANOVG_GL3
+#if NANOVG_GL_USE_VERTEXARRAY
 	glGenVertexArrays(1, &gl->vertArr);
 #endif
 	glGenBuffers(1, &gl->vertBuf);
@@ -797,13 +883,19 @@ static int glnvg__renderUpdateTexture(void* uptr, int image, int x, int y, int w
 	glPixelStorei(GL_UNPACK_SKIP_PIXELS, x);
 	glPixelStorei(GL_UNPACK_SKIP_ROWS, y);
 #else
-	// No support for all of skip, need to update a whole row at a time.
-	if (tex->type == NVG_TEXTURE_RGBA)
-		data += y*tex->width*4;
-	else
-		data += y*tex->width;
-	x = 0;
-	w = tex->width;
+	if (glnvg__unpackSubimage()) {
+		glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, tex->width);
+		glPixelStorei(GL_UNPACK_SKIP_PIXELS_EXT, x);
+		glPixelStorei(GL_UNPACK_SKIP_ROWS_EXT, y);
+	} else {
+		// No support for all of skip, need to update a whole row at a time.
+		if (tex->type == NVG_TEXTURE_RGBA)
+			data += y*tex->width*4;
+		else
+			data += y*tex->width;
+		x = 0;
+		w = tex->width;
+	}
 #endif
 
 	if (tex->type == NVG_TEXTURE_RGBA)
@@ -820,6 +912,12 @@ static int glnvg__renderUpdateTexture(void* uptr, int image, int x, int y, int w
 	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
 	glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+#else
+	if (glnvg__unpackSubimage()) {
+		glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0);
+		glPixelStorei(GL_UNPACK_SKIP_PIXELS_EXT, 0);
+		glPixelStorei(GL_UNPACK_SKIP_ROWS_EXT, 0);
+	}
 #endif
 
 	glnvg__bindTexture(gl, 0);
@@ -954,31 +1052,31 @@ static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 	int i, npaths = call->pathCount;
 
 	// Draw shapes
-	glEnable(GL_STENCIL_TEST);
+	glnvgEnable(GL_STENCIL_TEST);
 	glnvg__stencilMask(gl, 0xff);
 	glnvg__stencilFunc(gl, GL_ALWAYS, 0, 0xff);
-	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glnvgColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 
 	// set bindpoint for solid loc
 	glnvg__setUniforms(gl, call->uniformOffset, 0);
 	glnvg__checkError(gl, "fill simple");
 
-	glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
-	glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
-	glDisable(GL_CULL_FACE);
+	glnvgStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+	glnvgStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+	glnvgDisable(GL_CULL_FACE);
 	for (i = 0; i < npaths; i++)
 		glDrawArrays(GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
-	glEnable(GL_CULL_FACE);
+	glnvgEnable(GL_CULL_FACE);
 
 	// Draw anti-aliased pixels
-	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glnvgColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
 	glnvg__setUniforms(gl, call->uniformOffset + gl->fragSize, call->image);
 	glnvg__checkError(gl, "fill fill");
 
 	if (gl->flags & NVG_ANTIALIAS) {
 		glnvg__stencilFunc(gl, GL_EQUAL, 0x00, 0xff);
-		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+		glnvgStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 		// Draw fringes
 		for (i = 0; i < npaths; i++)
 			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
@@ -986,10 +1084,10 @@ static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 
 	// Draw fill
 	glnvg__stencilFunc(gl, GL_NOTEQUAL, 0x0, 0xff);
-	glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
+	glnvgStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
 	glDrawArrays(GL_TRIANGLES, call->triangleOffset, call->triangleCount);
 
-	glDisable(GL_STENCIL_TEST);
+	glnvgDisable(GL_STENCIL_TEST);
 }
 
 static void glnvg__convexFill(GLNVGcontext* gl, GLNVGcall* call)
@@ -1016,12 +1114,12 @@ static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 
 	if (gl->flags & NVG_STENCIL_STROKES) {
 
-		glEnable(GL_STENCIL_TEST);
+		glnvgEnable(GL_STENCIL_TEST);
 		glnvg__stencilMask(gl, 0xff);
 
 		// Fill the stroke base without overlap
 		glnvg__stencilFunc(gl, GL_EQUAL, 0x0, 0xff);
-		glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+		glnvgStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
 		glnvg__setUniforms(gl, call->uniformOffset + gl->fragSize, call->image);
 		glnvg__checkError(gl, "stroke fill 0");
 		for (i = 0; i < npaths; i++)
@@ -1030,20 +1128,20 @@ static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 		// Draw anti-aliased pixels.
 		glnvg__setUniforms(gl, call->uniformOffset, call->image);
 		glnvg__stencilFunc(gl, GL_EQUAL, 0x00, 0xff);
-		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+		glnvgStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 		for (i = 0; i < npaths; i++)
 			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 
 		// Clear stencil buffer.		
-		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		glnvgColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 		glnvg__stencilFunc(gl, GL_ALWAYS, 0x0, 0xff);
-		glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
+		glnvgStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
 		glnvg__checkError(gl, "stroke fill 1");
 		for (i = 0; i < npaths; i++)
 			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
-		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		glnvgColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
-		glDisable(GL_STENCIL_TEST);
+		glnvgDisable(GL_STENCIL_TEST);
 
 //		glnvg__convertPaint(gl, nvg__fragUniformPtr(gl, call->uniformOffset + gl->fragSize), paint, scissor, strokeWidth, fringe, 1.0f - 0.5f/255.0f);
 
@@ -1080,21 +1178,21 @@ static void glnvg__renderFlush(void* uptr)
 	if (gl->ncalls > 0) {
 
 		// Setup require GL state.
-		glUseProgram(gl->shader.prog);
-
-		glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_BACK);
-		glFrontFace(GL_CCW);
-		glEnable(GL_BLEND);
-		glDisable(GL_DEPTH_TEST);
-		glDisable(GL_SCISSOR_TEST);
-		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-		glStencilMask(0xffffffff);
-		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-		glStencilFunc(GL_ALWAYS, 0, 0xffffffff);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		glnvgUseProgram(gl->shader.prog);
+
+		glnvgBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		glnvgEnable(GL_CULL_FACE);
+		glnvgCullFace(GL_BACK);
+		glnvgFrontFace(GL_CCW);
+		glnvgEnable(GL_BLEND);
+		glnvgDisable(GL_DEPTH_TEST);
+		glnvgDisable(GL_SCISSOR_TEST);
+		glnvgColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		glnvgStencilMask(0xffffffff);
+		glnvgStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+		glnvgStencilFunc(GL_ALWAYS, 0, 0xffffffff);
+		glnvgActiveTexture(GL_TEXTURE0);
+		glnvgBindTexture(GL_TEXTURE_2D, 0);
 		#if NANOVG_GL_USE_STATE_FILTER
 		gl->boundTexture = 0;
 		gl->stencilMask = 0xffffffff;
@@ -1105,27 +1203,27 @@ static void glnvg__renderFlush(void* uptr)
 
 #if NANOVG_GL_USE_UNIFORMBUFFER
 		// Upload ubo for frag shaders
-		glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
+		glnvgBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
 		glBufferData(GL_UNIFORM_BUFFER, gl->nuniforms * gl->fragSize, gl->uniforms, GL_STREAM_DRAW);
 #endif
 
 		// Upload vertex data
-#if defined NANOVG_GL3
-		glBindVertexArray(gl->vertArr);
+#if NANOVG_GL_USE_VERTEXARRAY
+		glnvgBindVertexArray(gl->vertArr);
 #endif
-		glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
+		glnvgBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
 		glBufferData(GL_ARRAY_BUFFER, gl->nverts * sizeof(NVGvertex), gl->verts, GL_STREAM_DRAW);
-		glEnableVertexAttribArray(0);
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(size_t)0);
-		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(0 + 2*sizeof(float)));
+		glnvgEnableVertexAttribArray(0);
+		glnvgEnableVertexAttribArray(1);
+		glnvgVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(size_t)0);
+		glnvgVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(0 + 2*sizeof(float)));
 
 		// Set view and texture just once per frame.
 		glUniform1i(gl->shader.loc[GLNVG_LOC_TEX], 0);
 		glUniform2fv(gl->shader.loc[GLNVG_LOC_VIEWSIZE], 1, gl->view);
 
 #if NANOVG_GL_USE_UNIFORMBUFFER
-		glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
+		glnvgBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
 #endif
 
 		for (i = 0; i < gl->ncalls; i++) {
@@ -1140,15 +1238,19 @@ static void glnvg__renderFlush(void* uptr)
 				glnvg__triangles(gl, call);
 		}
 
-		glDisableVertexAttribArray(0);
-		glDisableVertexAttribArray(1);
-#if defined NANOVG_GL3
-		glBindVertexArray(0);
-#endif	
-		glDisable(GL_CULL_FACE);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glUseProgram(0);
+		// The state cache keeps track of what is bound, only reset the state when it is not used.
+#if NANOVG_GL_USE_VERTEXARRAY
+		// Always unbound, client side arrays and other users' layouts would otherwise end up in nanovg's array
+		glnvgBindVertexArray(0);
+#endif
+#if !NANOVG_GL_USE_STATE_CACHE
+		glnvgDisableVertexAttribArray(0);
+		glnvgDisableVertexAttribArray(1);
+		glnvgDisable(GL_CULL_FACE);
+			glnvgBindBuffer(GL_ARRAY_BUFFER, 0);
+		glnvgUseProgram(0);
 		glnvg__bindTexture(gl, 0);
+#endif
 	}
 
 	// Reset calls
@@ -1423,20 +1525,20 @@ static void glnvg__renderDelete(void* uptr)
 
 	glnvg__deleteShader(&gl->shader);
 
-#if NANOVG_GL3
 #if NANOVG_GL_USE_UNIFORMBUFFER
 	if (gl->fragBuf != 0)
-		glDeleteBuffers(1, &gl->fragBuf);
+		glnvgDeleteBuffers(1, &gl->fragBuf);
 #endif
+#if NANOVG_GL_USE_VERTEXARRAY
 	if (gl->vertArr != 0)
-		glDeleteVertexArrays(1, &gl->vertArr);
+		glnvgDeleteVertexArrays(1, &gl->vertArr);
 #endif
 	if (gl->vertBuf != 0)
-		glDeleteBuffers(1, &gl->vertBuf);
+		glnvgDeleteBuffers(1, &gl->vertBuf);
 
 	for (i = 0; i < gl->ntextures; i++) {
 		if (gl->textures[i].tex != 0 && (gl->textures[i].flags & NVG_IMAGE_NODELETE) == 0)
-			glDeleteTextures(1, &gl->textures[i].tex);
+			glnvgDeleteTextures(1, &gl->textures[i].tex);
 	}
 	free(gl->textures);
 
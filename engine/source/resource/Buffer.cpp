@@ -1,5 +1,15 @@
 #include <engine/resource/Buffer.hpp>
-#include <glad/glad.h>
+#include <engine/GLState.hpp>
+
+#include <vector>
+
+namespace
+{
+	// Names of destroyed buffers, handed out again by create() instead of going through glDeleteBuffers/glGenBuffers.
+	// Their data stores are released when they are recycled, only the names are kept.
+	const size_t MaxRecycledNames = 32;
+	std::vector<GLuint> recycled;
+}
 
 Buffer::Buffer()
 { }
@@ -10,26 +20,47 @@ Buffer::~Buffer()
 void Buffer::create()
 {
 	destroy();
-	glGenBuffers(1, &_id);
+	if(recycled.empty())
+		glGenBuffers(1, &_id);
+	else
+	{
+		_id = recycled.back();
+		recycled.pop_back();
+	}
 }
 
 void Buffer::destroy()
 {
 	if(_id != 0)
 	{
-		glDeleteBuffers(1, &_id);
+		if(recycled.size() < MaxRecycledNames)
+		{
+			GLState::bind_buffer(GL_ARRAY_BUFFER, _id);
+			glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+			GLState::bind_buffer(GL_ARRAY_BUFFER, 0);
+			recycled.push_back(_id);
+		}
+		else
+			GLState::delete_buffers(1, &_id);
 		_id = 0;
 	}
 }
 
+void Buffer::release_recycled()
+{
+	if(!recycled.empty())
+		GLState::delete_buffers((GLsizei) recycled.size(), recycled.data());
+	recycled.clear();
+}
+
 void Buffer::bind(Target const& target, glm::uint id)
 {
-	glBindBuffer(static_cast<GLenum>(target), id);
+	GLState::bind_buffer(static_cast<GLenum>(target), id);
 }
 
 void Buffer::unbind(Target const& target)
 {
-	glBindBuffer(static_cast<GLenum>(target), 0);
+	GLState::bind_buffer(static_cast<GLenum>(target), 0);
 }
 
 void Buffer::data(Target const& target, glm::int64 size, void const* ptr, Usage const& usage)
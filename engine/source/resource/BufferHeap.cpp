@@ -0,0 +1,224 @@
+#include <engine/resource/BufferHeap.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+using namespace std;
+
+namespace
+{
+	inline glm::int64 align_up(glm::int64 value, glm::int64 alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+BufferHeap::BufferHeap(Buffer::Target target, Buffer::Usage usage, glm::int64 page_size, glm::int64 alignment, bool keep_shadow) :
+		_target(target), _usage(usage), _page_size(page_size), _alignment(alignment), _keep_shadow(keep_shadow), _next(Invalid)
+{
+	if(page_size <= 0 || alignment <= 0) throw invalid_argument("BufferHeap page size and alignment must be positive");
+}
+
+BufferHeap::~BufferHeap()
+{ }
+
+size_t BufferHeap::add_page(glm::int64 size)
+{
+	unique_ptr<Page> page{new Page};
+	page->size = size;
+	page->free[0] = size;
+	page->live = 0;
+	if(_keep_shadow)
+		page->shadow.resize((size_t) size);
+
+	page->buffer.create();
+	Buffer::bind(_target, page->buffer.id());
+	Buffer::data(_target, size, nullptr, _usage);
+
+	auto empty = find(_pages.begin(), _pages.end(), nullptr);
+	if(empty != _pages.end())
+	{
+		*empty = move(page);
+		return (size_t) (empty - _pages.begin());
+	}
+	_pages.push_back(move(page));
+	return _pages.size() - 1;
+}
+
+BufferHeap::Allocation BufferHeap::allocate(glm::int64 size)
+{
+	if(size <= 0) throw invalid_argument("BufferHeap allocations must have a positive size");
+	size = align_up(size, _alignment);
+
+	// Best fit over every page, the smallest block that fits leaves the largest blocks for large meshes
+	size_t best_page = 0;
+	map<glm::int64, glm::int64>::iterator best;
+	bool found = false;
+	for(size_t p = 0; p < _pages.size(); ++p)
+	{
+		if(!_pages[p]) continue;
+		for(auto it = _pages[p]->free.begin(); it != _pages[p]->free.end(); ++it)
+		{
+			if(it->second >= size && (!found || it->second < best->second))
+			{
+				best_page = p;
+				best = it;
+				found = true;
+			}
+		}
+	}
+
+	if(!found)
+	{
+		best_page = add_page(max(size, _page_size));
+		best = _pages[best_page]->free.begin();
+	}
+
+	Page& page = *_pages[best_page];
+	glm::int64 offset = best->first;
+	glm::int64 remaining = best->second - size;
+	page.free.erase(best);
+	if(remaining > 0)
+		page.free[offset + size] = remaining;
+	++page.live;
+
+	Allocation id = ++_next;
+	if(id == Invalid)
+		id = ++_next;
+	_blocks[id] = {best_page, offset, size};
+	return id;
+}
+
+void BufferHeap::release(Page& page, glm::int64 offset, glm::int64 size)
+{
+	auto it = page.free.emplace(offset, size).first;
+
+	auto next = std::next(it);
+	if(next != page.free.end() && it->first + it->second == next->first)
+	{
+		it->second += next->second;
+		page.free.erase(next);
+	}
+
+	if(it != page.free.begin())
+	{
+		auto prev = std::prev(it);
+		if(prev->first + prev->second == it->first)
+		{
+			prev->second += it->second;
+			page.free.erase(it);
+		}
+	}
+}
+
+void BufferHeap::free(Allocation alloc)
+{
+	auto it = _blocks.find(alloc);
+	if(it == _blocks.end())
+		return;
+
+	Page& page = *_pages[it->second.page];
+	release(page, it->second.offset, it->second.size);
+	--page.live;
+	_blocks.erase(it);
+}
+
+void BufferHeap::upload(Allocation alloc, void const* ptr, glm::int64 size, glm::int64 offset)
+{
+	auto it = _blocks.find(alloc);
+	if(it == _blocks.end()) throw invalid_argument("Invalid BufferHeap allocation");
+	if(offset < 0 || offset + size > it->second.size) throw out_of_range("BufferHeap upload is out of the allocation range");
+
+	Page& page = *_pages[it->second.page];
+	if(_keep_shadow)
+		memcpy(&page.shadow[(size_t) (it->second.offset + offset)], ptr, (size_t) size);
+
+	Buffer::bind(_target, page.buffer.id());
+	Buffer::subdata(_target, it->second.offset + offset, size, ptr);
+}
+
+BufferHeap::Range BufferHeap::range(Allocation alloc) const
+{
+	auto it = _blocks.find(alloc);
+	if(it == _blocks.end())
+		return {0, 0, 0};
+	return {_pages[it->second.page]->buffer.id(), it->second.offset, it->second.size};
+}
+
+void BufferHeap::bind(Allocation alloc) const
+{
+	Buffer::bind(_target, range(alloc).buffer);
+}
+
+void BufferHeap::defragment()
+{
+	// Empty pages go back to GL whatever happens, only keep one around to absorb the next allocations
+	bool kept = false;
+	for(auto& page : _pages)
+	{
+		if(!page || page->live > 0) continue;
+		if(!kept)
+			kept = true;
+		else
+			page.reset();
+	}
+
+	if(!_keep_shadow)
+		return;
+
+	vector<vector<Block*>> live(_pages.size());
+	for(auto& b : _blocks)
+		live[b.second.page].push_back(&b.second);
+
+	for(size_t p = 0; p < _pages.size(); ++p)
+	{
+		if(!_pages[p] || live[p].empty()) continue;
+
+		// Already compact when the only free block is at the end of the page
+		Page& page = *_pages[p];
+		if(page.free.empty() || (page.free.size() == 1 && page.free.begin()->first + page.free.begin()->second == page.size))
+			continue;
+
+		sort(live[p].begin(), live[p].end(), [](Block const* a, Block const* b) { return a->offset < b->offset; });
+
+		glm::int64 end = 0;
+		for(Block* b : live[p])
+		{
+			if(b->offset != end)
+			{
+				memmove(&page.shadow[(size_t) end], &page.shadow[(size_t) b->offset], (size_t) b->size);
+				b->offset = end;
+			}
+			end += b->size;
+		}
+
+		page.free.clear();
+		if(end < page.size)
+			page.free[end] = page.size - end;
+
+		Buffer::bind(_target, page.buffer.id());
+		Buffer::subdata(_target, 0, end, page.shadow.data());
+	}
+}
+
+BufferHeap::Stats BufferHeap::stats() const
+{
+	Stats ret{0, _blocks.size(), 0, 0, 0, 0};
+	for(auto const& page : _pages)
+	{
+		if(!page) continue;
+		++ret.pages;
+		ret.capacity += page->size;
+		ret.free_blocks += page->free.size();
+
+		glm::int64 free = 0;
+		for(auto const& f : page->free)
+		{
+			free += f.second;
+			ret.largest_free = max(ret.largest_free, f.second);
+		}
+		ret.used += page->size - free;
+	}
+	return ret;
+}
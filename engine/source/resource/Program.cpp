@@ -0,0 +1,290 @@
+#include <engine/resource/Program.hpp>
+#include <engine/GLState.hpp>
+#include <engine/Engine.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <cstdint>
+#include <cstdio>
+
+using namespace std;
+
+namespace
+{
+	struct CacheHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t format;
+		uint32_t length;
+	};
+
+	const char CacheMagic[4]{'G', 'P', 'B', 'C'};
+	const uint32_t CacheVersion = 1;
+
+	filesystem::Path cache_dir{"shader_cache"};
+
+	inline uint64_t fnv1a(uint64_t hash, void const* data, size_t size)
+	{
+		auto bytes = static_cast<unsigned char const*>(data);
+		for(size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	inline uint64_t fnv1a(uint64_t hash, string const& str)
+	{
+		// Hash the terminator too so "ab" + "c" and "a" + "bc" do not collide
+		return fnv1a(hash, str.c_str(), str.size() + 1);
+	}
+
+	inline uint64_t fnv1a(uint64_t hash, GLenum name)
+	{
+		auto str = reinterpret_cast<char const*>(glGetString(name));
+		return fnv1a(hash, string{str != nullptr ? str : ""});
+	}
+
+	filesystem::Path cache_file(string const& vertex, string const& fragment, Program::AttributeBindings const& attributes)
+	{
+		uint64_t hash = 0xcbf29ce484222325ull;
+		hash = fnv1a(hash, vertex);
+		hash = fnv1a(hash, fragment);
+		for(auto const& a : attributes)
+		{
+			hash = fnv1a(hash, &a.first, sizeof(a.first));
+			hash = fnv1a(hash, a.second);
+		}
+		hash = fnv1a(hash, GL_VENDOR);
+		hash = fnv1a(hash, GL_RENDERER);
+		hash = fnv1a(hash, GL_VERSION);
+
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long) hash);
+		return cache_dir / filesystem::Path(name);
+	}
+
+	bool binary_supported()
+	{
+		if(!GLAD_GL_OES_get_program_binary || cache_dir.empty())
+			return false;
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats);
+		return formats > 0;
+	}
+
+	GLuint load_binary(filesystem::Path& file)
+	{
+		if(!file.is_file())
+			return 0;
+
+		ifstream in{file.str(), ios::binary};
+		CacheHeader header;
+		if(!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		   !equal(begin(CacheMagic), end(CacheMagic), header.magic) || header.version != CacheVersion)
+		{
+			WARN("Program::link => Ignoring invalid program cache '{}'", file.str());
+			file.remove_file();
+			return 0;
+		}
+
+		// A corrupt length must not reach the allocation, the file holds the whole binary after the header
+		if(header.length > file.file_size() - sizeof(CacheHeader))
+		{
+			WARN("Program::link => Ignoring program cache '{}' with an invalid length", file.str());
+			file.remove_file();
+			return 0;
+		}
+
+		vector<char> data(header.length);
+		if(!in.read(data.data(), header.length))
+		{
+			WARN("Program::link => Ignoring truncated program cache '{}'", file.str());
+			file.remove_file();
+			return 0;
+		}
+
+		GLuint prog = glCreateProgram();
+		glProgramBinaryOES(prog, header.format, data.data(), (GLint) header.length);
+
+		GLint status = GL_FALSE;
+		glGetProgramiv(prog, GL_LINK_STATUS, &status);
+		if(status != GL_TRUE)
+		{
+			// Drivers reject binaries after an update, rebuild from source
+			DEBUG("Program::link => Program cache '{}' rejected by the driver", file.str());
+			GLState::delete_program(prog);
+			file.remove_file();
+			return 0;
+		}
+
+		TRACE("Program::link => Loaded program from cache '{}'", file.str());
+		return prog;
+	}
+
+	void save_binary(GLuint prog, filesystem::Path const& file)
+	{
+		GLint length = 0;
+		glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+		if(length <= 0)
+			return;
+
+		CacheHeader header;
+		copy(begin(CacheMagic), end(CacheMagic), header.magic);
+		header.version = CacheVersion;
+
+		vector<char> data((size_t) length);
+		GLsizei written = 0;
+		GLenum format = 0;
+		glGetProgramBinaryOES(prog, length, &written, &format, data.data());
+		header.format = format;
+		header.length = (uint32_t) written;
+
+		if(!cache_dir.is_directory())
+			filesystem::create_directory(cache_dir);
+
+		ofstream out{file.str(), ios::binary | ios::trunc};
+		out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		out.write(data.data(), written);
+		if(!out)
+			WARN("Program::link => Could not write program cache '{}'", file.str());
+	}
+
+	GLuint compile(GLenum type, string const& source)
+	{
+		GLuint shader = glCreateShader(type);
+		char const* str = source.c_str();
+		glShaderSource(shader, 1, &str, nullptr);
+		glCompileShader(shader);
+
+		GLint status = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+		if(status != GL_TRUE)
+		{
+			GLchar log[512 + 1];
+			GLsizei len = 0;
+			glGetShaderInfoLog(shader, 512, &len, log);
+			log[len] = '\0';
+			glDeleteShader(shader);
+			throw runtime_error(string{type == GL_VERTEX_SHADER ? "Vertex" : "Fragment"} + " shader compilation failed : " + log);
+		}
+		return shader;
+	}
+}
+
+Program::Program() : _from_cache(false)
+{ }
+
+Program::~Program()
+{ destroy(); }
+
+void Program::create()
+{
+	destroy();
+	_id = glCreateProgram();
+}
+
+void Program::destroy()
+{
+	if(_id != 0)
+	{
+		GLState::delete_program(_id);
+		_id = 0;
+	}
+	_from_cache = false;
+}
+
+void Program::build(string const& vertex, string const& fragment, AttributeBindings const& attributes)
+{
+	destroy();
+	_id = link(vertex, fragment, attributes, &_from_cache);
+}
+
+void Program::use() const
+{
+	GLState::use_program(_id);
+}
+
+int Program::uniform_location(string const& name) const
+{
+	return glGetUniformLocation(_id, name.c_str());
+}
+
+int Program::attribute_location(string const& name) const
+{
+	return glGetAttribLocation(_id, name.c_str());
+}
+
+glm::uint Program::link(string const& vertex, string const& fragment, AttributeBindings const& attributes, bool* from_cache)
+{
+	if(from_cache != nullptr)
+		*from_cache = false;
+
+	bool binary = binary_supported();
+	filesystem::Path file;
+	if(binary)
+	{
+		file = cache_file(vertex, fragment, attributes);
+		GLuint prog = load_binary(file);
+		if(prog != 0)
+		{
+			if(from_cache != nullptr)
+				*from_cache = true;
+			return prog;
+		}
+	}
+
+	GLuint vert = compile(GL_VERTEX_SHADER, vertex);
+	GLuint frag = 0;
+	try
+	{
+		frag = compile(GL_FRAGMENT_SHADER, fragment);
+	}
+	catch(...)
+	{
+		glDeleteShader(vert);
+		throw;
+	}
+
+	GLuint prog = glCreateProgram();
+	glAttachShader(prog, vert);
+	glAttachShader(prog, frag);
+	for(auto const& a : attributes)
+		glBindAttribLocation(prog, a.first, a.second.c_str());
+	glLinkProgram(prog);
+
+	// The program keeps what it needs, the shader objects can go right away
+	glDetachShader(prog, vert);
+	glDetachShader(prog, frag);
+	glDeleteShader(vert);
+	glDeleteShader(frag);
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(prog, GL_LINK_STATUS, &status);
+	if(status != GL_TRUE)
+	{
+		GLchar log[512 + 1];
+		GLsizei len = 0;
+		glGetProgramInfoLog(prog, 512, &len, log);
+		log[len] = '\0';
+		GLState::delete_program(prog);
+		throw runtime_error(string{"Program link failed : "} + log);
+	}
+
+	if(binary)
+		save_binary(prog, file);
+	return prog;
+}
+
+void Program::cache_directory(filesystem::Path const& dir)
+{
+	cache_dir = dir;
+}
+
+filesystem::Path const& Program::cache_directory()
+{
+	return cache_dir;
+}
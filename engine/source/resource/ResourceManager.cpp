@@ -0,0 +1,113 @@
+#include <engine/resource/ResourceManager.hpp>
+
+using namespace std;
+
+ResourceManager::ResourceManager(glm::uint frames_in_flight) : _retired(frames_in_flight + 1), _frame(0), _live(0)
+{ }
+
+ResourceManager::~ResourceManager()
+{ clear(); }
+
+RawHandle ResourceManager::insert(unique_ptr<Resource> res)
+{
+	lock_guard<mutex> lock{_mutex};
+
+	glm::uint index;
+	if(_free.empty())
+	{
+		index = (glm::uint) _slots.size();
+		_slots.push_back(Slot{nullptr, 1, 0});
+	}
+	else
+	{
+		index = _free.back();
+		_free.pop_back();
+	}
+
+	Slot& slot = _slots[index];
+	slot.resource = move(res);
+	slot.references = 1;
+	++_live;
+	return {index, slot.generation};
+}
+
+Resource* ResourceManager::lookup(RawHandle const& handle) const
+{
+	lock_guard<mutex> lock{_mutex};
+	if(handle.index >= _slots.size() || _slots[handle.index].generation != handle.generation)
+		return nullptr;
+	return _slots[handle.index].resource.get();
+}
+
+void ResourceManager::retain(RawHandle const& handle)
+{
+	lock_guard<mutex> lock{_mutex};
+	if(handle.index < _slots.size() && _slots[handle.index].generation == handle.generation)
+		++_slots[handle.index].references;
+}
+
+void ResourceManager::drop(RawHandle const& handle)
+{
+	lock_guard<mutex> lock{_mutex};
+	if(handle.index >= _slots.size())
+		return;
+
+	Slot& slot = _slots[handle.index];
+	if(slot.generation != handle.generation || --slot.references > 0)
+		return;
+
+	// Stale from now on, but the GL object lives until the frames using it are done
+	_retired[_frame % _retired.size()].push_back(move(slot.resource));
+	if(++slot.generation == 0)
+		slot.generation = 1;
+	_free.push_back(handle.index);
+	--_live;
+}
+
+void ResourceManager::collect()
+{
+	vector<unique_ptr<Resource>> expired;
+	{
+		lock_guard<mutex> lock{_mutex};
+		++_frame;
+		expired.swap(_retired[_frame % _retired.size()]);
+	}
+	// Destroyed outside of the lock, resources may release other handles while being destroyed
+	expired.clear();
+}
+
+void ResourceManager::clear()
+{
+	vector<unique_ptr<Resource>> expired;
+	{
+		lock_guard<mutex> lock{_mutex};
+		for(auto& r : _retired)
+		{
+			for(auto& res : r)
+				expired.push_back(move(res));
+			r.clear();
+		}
+		for(auto& slot : _slots)
+			if(slot.resource)
+				expired.push_back(move(slot.resource));
+		_slots.clear();
+		_free.clear();
+		_live = 0;
+	}
+	expired.clear();
+}
+
+size_t ResourceManager::size() const
+{
+	lock_guard<mutex> lock{_mutex};
+	return _live;
+}
+
+size_t ResourceManager::pending() const
+{
+	lock_guard<mutex> lock{_mutex};
+	size_t count = 0;
+	for(auto const& r : _retired)
+		count += r.size();
+	return count;
+}
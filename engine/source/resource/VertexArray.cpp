@@ -1,19 +1,78 @@
 #include <engine/resource/VertexArray.hpp>
-#include <glad/glad.h>
+#include <engine/GLState.hpp>
+
+#include <glad/glad_es3.h>
+
+VertexArray::VertexArray() : _array_buffer(0), _element_buffer(0), _base(0), _apply(nullptr)
+{ }
+
+VertexArray::~VertexArray()
+{ destroy(); }
+
+void VertexArray::create()
+{
+	destroy();
+	if(GLAD_GL_ES_VERSION_3_0)
+		glGenVertexArrays(1, &_id);
+	else if(GLAD_GL_OES_vertex_array_object)
+		glGenVertexArraysOES(1, &_id);
+}
+
+void VertexArray::destroy()
+{
+	if(_id != 0)
+	{
+		GLState::delete_vertex_arrays(1, &_id);
+		_id = 0;
+	}
+	_apply = nullptr;
+}
+
+bool VertexArray::supported()
+{
+	return GLAD_GL_ES_VERSION_3_0 || GLAD_GL_OES_vertex_array_object;
+}
+
+void VertexArray::record()
+{
+	GLState::bind_vertex_array(_id);
+	GLState::bind_buffer(GL_ARRAY_BUFFER, _array_buffer);
+	GLState::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, _element_buffer);
+	_apply(_base);
+}
+
+void VertexArray::bind() const
+{
+	if(_id != 0)
+		GLState::bind_vertex_array(_id);
+	else if(_apply != nullptr)
+	{
+		// Nothing was recorded in GL, this is the path without vertex array objects
+		GLState::bind_vertex_array(0);
+		GLState::bind_buffer(GL_ARRAY_BUFFER, _array_buffer);
+		GLState::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, _element_buffer);
+		_apply(_base);
+	}
+}
+
+void VertexArray::unbind()
+{
+	GLState::bind_vertex_array(0);
+}
 
 void VertexArray::enable_attribute_index(glm::uint index)
 {
-	glEnableVertexAttribArray(index);
+	GLState::enable_attribute(index);
 }
 
 void VertexArray::disable_attribute_index(glm::uint index)
 {
-	glDisableVertexAttribArray(index);
+	GLState::disable_attribute(index);
 }
 
 void VertexArray::attribute_pointer(glm::uint index, int size, const VertexArray::Type& type, bool normalized, int stride, void const* ptr)
 {
-	glVertexAttribPointer(index, size, static_cast<GLenum>(type), (GLboolean) (normalized ? GL_TRUE : GL_FALSE), stride, ptr);
+	GLState::attribute_pointer(index, size, static_cast<GLenum>(type), normalized, stride, ptr);
 }
 
 void VertexArray::draw(Mode const& mode, int first, int count)
@@ -0,0 +1,359 @@
+#include <engine/utils/Archive.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+using namespace std;
+
+namespace
+{
+	const char ArchiveMagic[4]{'G', 'P', 'A', 'K'};
+
+	// LZ4 block format constants, the last 5 bytes are always literals and no match starts in the last 12
+	const size_t MinMatch = 4;
+	const size_t LastLiterals = 5;
+	const size_t MatchLimit = 12;
+	const size_t MaxOffset = 65535;
+	const int HashBits = 12;
+
+	inline uint32_t read32(unsigned char const* ptr)
+	{
+		uint32_t v;
+		memcpy(&v, ptr, sizeof(v));
+		return v;
+	}
+
+	inline void write_length(vector<unsigned char>& out, size_t len)
+	{
+		for(; len >= 255; len -= 255)
+			out.push_back(255);
+		out.push_back((unsigned char) len);
+	}
+
+	inline bool read_length(unsigned char const* src, size_t size, size_t& ip, size_t& len)
+	{
+		unsigned char b;
+		do
+		{
+			if(ip >= size) return false;
+			b = src[ip++];
+			len += b;
+		} while(b == 255);
+		return true;
+	}
+
+	void write_sequence(vector<unsigned char>& out, unsigned char const* literals, size_t literal_count, size_t offset, size_t match)
+	{
+		size_t ml = match != 0 ? match - MinMatch : 0;
+		out.push_back((unsigned char) ((min<size_t>(literal_count, 15) << 4) | min<size_t>(ml, 15)));
+		if(literal_count >= 15)
+			write_length(out, literal_count - 15);
+		out.insert(out.end(), literals, literals + literal_count);
+		if(match == 0)
+			return;
+
+		out.push_back((unsigned char) (offset & 0xff));
+		out.push_back((unsigned char) (offset >> 8));
+		if(ml >= 15)
+			write_length(out, ml - 15);
+	}
+
+	// Written as a subtraction, offset + length may wrap around on a corrupt archive
+	inline bool fits(uint64_t offset, uint64_t length, uint64_t size)
+	{
+		return offset <= size && length <= size - offset;
+	}
+
+	inline void align(ofstream& out, uint64_t& offset, uint32_t alignment)
+	{
+		static const char zeros[64]{};
+		uint64_t padding = (alignment - offset % alignment) % alignment;
+		offset += padding;
+		for(; padding > 0; padding -= min<uint64_t>(padding, sizeof(zeros)))
+			out.write(zeros, (streamsize) min<uint64_t>(padding, sizeof(zeros)));
+	}
+}
+
+Archive::Archive(filesystem::Path const& file) : _file(file), _toc(nullptr), _names(nullptr), _count(0)
+{
+	if(_file.size() < sizeof(Header)) throw runtime_error("Archive '" + file.str() + "' is truncated");
+
+	Header const* header = reinterpret_cast<Header const*>(_file.data());
+	if(!equal(begin(ArchiveMagic), end(ArchiveMagic), header->magic) || header->version != Version)
+		throw runtime_error("Archive '" + file.str() + "' is not a supported archive");
+	if(!fits(header->toc_offset, (uint64_t) header->count * sizeof(Entry), _file.size()) || header->names_offset > _file.size())
+		throw runtime_error("Archive '" + file.str() + "' is truncated");
+	// The mapping is page aligned, the entries are read in place
+	if(header->toc_offset % alignof(Entry) != 0)
+		throw runtime_error("Archive '" + file.str() + "' has a misaligned table of contents");
+
+	_toc = reinterpret_cast<Entry const*>(_file.data() + header->toc_offset);
+	_names = reinterpret_cast<char const*>(_file.data() + header->names_offset);
+	_count = header->count;
+
+	for(size_t i = 0; i < _count; ++i)
+	{
+		// Stored entries are read and viewed with their unpacked size
+		if(!fits(_toc[i].offset, _toc[i].stored_size, _file.size()) ||
+		   !fits(header->names_offset, (uint64_t) _toc[i].name_offset + _toc[i].name_length, _file.size()) ||
+		   (!(_toc[i].flags & Compressed) && _toc[i].size != _toc[i].stored_size))
+			throw runtime_error("Archive '" + file.str() + "' has an entry out of bounds");
+	}
+}
+
+uint64_t Archive::hash(string const& name)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for(char c : name)
+	{
+		hash ^= (unsigned char) (c == '\\' ? '/' : c);
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+Archive::Entry const* Archive::find(string const& name) const
+{
+	uint64_t h = hash(name);
+	auto it = lower_bound(_toc, _toc + _count, h, [](Entry const& e, uint64_t value) { return e.hash < value; });
+	for(; it != _toc + _count && it->hash == h; ++it)
+	{
+		if(it->name_length == name.size() && equal(name.begin(), name.end(), _names + it->name_offset,
+													[](char a, char b) { return (a == '\\' ? '/' : a) == b; }))
+			return it;
+	}
+	return nullptr;
+}
+
+Archive::Entry const& Archive::get(string const& name) const
+{
+	Entry const* e = find(name);
+	if(e == nullptr) throw invalid_argument("Archive does not contain '" + name + "'");
+	return *e;
+}
+
+bool Archive::contains(string const& name) const
+{
+	return find(name) != nullptr;
+}
+
+bool Archive::compressed(string const& name) const
+{
+	return (get(name).flags & Compressed) != 0;
+}
+
+size_t Archive::size(string const& name) const
+{
+	return (size_t) get(name).size;
+}
+
+Archive::View Archive::view(string const& name) const
+{
+	Entry const& e = get(name);
+	if(e.flags & Compressed)
+		return {nullptr, 0};
+	return {_file.data() + e.offset, (size_t) e.size};
+}
+
+vector<unsigned char> Archive::read(string const& name) const
+{
+	vector<unsigned char> ret(size(name));
+	read(name, ret.data());
+	return ret;
+}
+
+void Archive::read(string const& name, unsigned char* dst) const
+{
+	Entry const& e = get(name);
+	if(!(e.flags & Compressed))
+	{
+		memcpy(dst, _file.data() + e.offset, (size_t) e.size);
+		return;
+	}
+
+	if(!decompress(_file.data() + e.offset, (size_t) e.stored_size, dst, (size_t) e.size))
+		throw runtime_error("Archive entry '" + name + "' is corrupted");
+}
+
+vector<string> Archive::names() const
+{
+	vector<string> ret;
+	ret.reserve(_count);
+	for(size_t i = 0; i < _count; ++i)
+		ret.emplace_back(_names + _toc[i].name_offset, _toc[i].name_length);
+	return ret;
+}
+
+vector<unsigned char> Archive::compress(unsigned char const* data, size_t size)
+{
+	vector<unsigned char> out;
+	out.reserve(size + size / 255 + 16);
+
+	// Greedy matching against the last position of each 4 bytes hash, positions are stored + 1 so 0 is empty
+	vector<size_t> table(1 << HashBits, 0);
+	size_t anchor = 0;
+	size_t i = 0;
+	while(size >= MatchLimit && i + MatchLimit <= size)
+	{
+		uint32_t seq = read32(data + i);
+		uint32_t h = (seq * 2654435761u) >> (32 - HashBits);
+		size_t candidate = table[h];
+		table[h] = i + 1;
+
+		if(candidate == 0 || i - (candidate - 1) > MaxOffset || read32(data + candidate - 1) != seq)
+		{
+			++i;
+			continue;
+		}
+
+		size_t ref = candidate - 1;
+		size_t len = MinMatch;
+		size_t max_len = size - LastLiterals - i;
+		while(len < max_len && data[ref + len] == data[i + len])
+			++len;
+
+		write_sequence(out, data + anchor, i - anchor, i - ref, len);
+		i += len;
+		anchor = i;
+	}
+
+	write_sequence(out, data + anchor, size - anchor, 0, 0);
+	return out;
+}
+
+bool Archive::decompress(unsigned char const* src, size_t size, unsigned char* dst, size_t dst_size)
+{
+	size_t ip = 0;
+	size_t op = 0;
+	while(ip < size)
+	{
+		unsigned char token = src[ip++];
+
+		size_t literals = token >> 4;
+		if(literals == 15 && !read_length(src, size, ip, literals))
+			return false;
+		if(ip + literals > size || op + literals > dst_size)
+			return false;
+		memcpy(dst + op, src + ip, literals);
+		ip += literals;
+		op += literals;
+
+		// The last sequence has no match
+		if(ip == size)
+			break;
+
+		if(ip + 2 > size)
+			return false;
+		size_t offset = src[ip] | (src[ip + 1] << 8);
+		ip += 2;
+		if(offset == 0 || offset > op)
+			return false;
+
+		size_t match = token & 15;
+		if(match == 15 && !read_length(src, size, ip, match))
+			return false;
+		match += MinMatch;
+		if(op + match > dst_size)
+			return false;
+
+		// Matches may overlap what they produce, copy byte by byte
+		for(size_t k = 0; k < match; ++k)
+			dst[op + k] = dst[op - offset + k];
+		op += match;
+	}
+	return op == dst_size;
+}
+
+ArchiveWriter::ArchiveWriter(filesystem::Path const& file, uint32_t alignment) :
+		_out(file.str(), ios::binary | ios::trunc), _alignment(alignment), _offset(sizeof(Archive::Header)), _finished(false)
+{
+	if(alignment == 0 || (alignment & (alignment - 1)) != 0) throw invalid_argument("Archive alignment must be a power of two");
+	if(!_out) throw runtime_error("Could not create archive '" + file.str() + "'");
+
+	Archive::Header header{};
+	_out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+}
+
+ArchiveWriter::~ArchiveWriter()
+{
+	if(!_finished)
+	{
+		try
+		{ finish(); }
+		catch(...)
+		{ }
+	}
+}
+
+void ArchiveWriter::add(string const& name, unsigned char const* data, size_t size, bool compress)
+{
+	if(_finished) throw logic_error("Archive is already finished");
+
+	uint64_t h = Archive::hash(name);
+	for(auto const& e : _entries)
+	{
+		if(e.hash == h && _names.compare(e.name_offset, e.name_length, name) == 0)
+			throw invalid_argument("Archive already contains '" + name + "'");
+	}
+
+	vector<unsigned char> packed;
+	if(compress && size > 0)
+	{
+		packed = Archive::compress(data, size);
+		if(packed.size() > size - size / 8)
+			packed.clear();
+	}
+
+	align(_out, _offset, _alignment);
+
+	Archive::Entry e{};
+	e.hash = h;
+	e.offset = _offset;
+	e.size = size;
+	e.stored_size = packed.empty() ? size : packed.size();
+	e.name_offset = (uint32_t) _names.size();
+	e.name_length = (uint32_t) name.size();
+	e.flags = packed.empty() ? 0 : Archive::Compressed;
+
+	if(packed.empty())
+		_out.write(reinterpret_cast<char const*>(data), (streamsize) size);
+	else
+		_out.write(reinterpret_cast<char const*>(packed.data()), (streamsize) packed.size());
+	_offset += e.stored_size;
+
+	_names += name;
+	replace(_names.end() - (ptrdiff_t) name.size(), _names.end(), '\\', '/');
+	_entries.push_back(e);
+}
+
+void ArchiveWriter::add_file(string const& name, filesystem::Path const& file, bool compress)
+{
+	filesystem::MappedFile mapped{file};
+	add(name, mapped.data(), mapped.size(), compress);
+}
+
+void ArchiveWriter::finish()
+{
+	if(_finished)
+		return;
+	_finished = true;
+
+	sort(_entries.begin(), _entries.end(), [](Archive::Entry const& a, Archive::Entry const& b) { return a.hash < b.hash; });
+
+	align(_out, _offset, alignof(Archive::Entry));
+	Archive::Header header;
+	copy(begin(ArchiveMagic), end(ArchiveMagic), header.magic);
+	header.version = Archive::Version;
+	header.count = (uint32_t) _entries.size();
+	header.alignment = _alignment;
+	header.toc_offset = _offset;
+	header.names_offset = _offset + _entries.size() * sizeof(Archive::Entry);
+
+	_out.write(reinterpret_cast<char const*>(_entries.data()), (streamsize) (_entries.size() * sizeof(Archive::Entry)));
+	_out.write(_names.data(), (streamsize) _names.size());
+	_out.seekp(0);
+	_out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+	_out.flush();
+	if(!_out) throw runtime_error("Could not write archive");
+}
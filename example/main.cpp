@@ -1,5 +1,6 @@
 #include <engine/Application.hpp>
 #include <engine/Painter.hpp>
+#include <engine/Script.hpp>
 
 using namespace std;
 
@@ -7,14 +8,48 @@ class ExampleApplication : public Application
 {
 	Painter* _p;
 
+	// --script-bench <count> draws count circles per frame from C++ and from Lua and logs both timings
+	int _bench_count;
+	int _bench_frames;
+	Duration _native_time;
+	Duration _script_time;
+
+	// --paint-bench <count> draws count stroked and filled stars per frame and logs the geometry and timings,
+	// run it once more with --msaa <samples> to compare with multisampling
+	int _paint_count;
+	Duration _build_time;
+	Duration _flush_time;
+	Painter::Stats _geometry;
+
 public:
-	ExampleApplication() : _p(nullptr)
+	ExampleApplication() : _p(nullptr), _bench_count(0), _bench_frames(0), _native_time(), _script_time(), _paint_count(0),
+						   _build_time(), _flush_time(), _geometry()
 	{
 		WARN("ExampleApplication => Constructed");
 	}
 
+	// The engine already exists at this point, its arguments are known
+	static DisplaySettings display_settings()
+	{
+		DisplaySettings settings;
+		auto args = Engine::ref().arguments();
+		for(auto it = args.begin(); it != args.end(); ++it)
+		{
+			auto next = std::next(it);
+			if(next == args.end())
+				break;
+			if(*it == "--msaa")
+				settings.msaa_samples = stoi(*next);
+			// Frame times would only show the refresh rate with vsync
+			if(*it == "--paint-bench")
+				settings.swap = SwapMode::Immediate;
+		}
+		return settings;
+	}
+
 	virtual ~ExampleApplication()
 	{
+		delete _p;
 		WARN("ExampleApplication => Destroyed");
 	}
 
@@ -22,22 +57,70 @@ public:
 	{
 		WARN("ExampleApplication => Initialized");
 		_p = new Painter;
+		engine().script().bind(_p);
+
+		auto args = engine().arguments();
+		for(auto it = args.begin(); it != args.end(); ++it)
+		{
+			auto next = std::next(it);
+			if(next == args.end())
+				break;
+			if(*it == "--script")
+				engine().script().load(filesystem::Path(*next));
+			if(*it == "--script-bench")
+				_bench_count = max(stoi(*next), 1);
+			if(*it == "--paint-bench")
+				_paint_count = max(stoi(*next), 1);
+		}
+
+		if(_bench_count > 0)
+		{
+			engine().script().run(R"(
+				function bench_circles(n)
+					painter:fill_color(1, 0, 0, 1)
+					for i = 1, n do
+						painter:begin_path()
+						painter:circle(i % 1900 + 10, i % 1060 + 10, 8)
+						painter:fill()
+					end
+				end
+			)", "bench");
+			WARN("ExampleApplication => Benchmarking {} circles per frame", _bench_count);
+		}
+		if(_paint_count > 0)
+			WARN("ExampleApplication => Benchmarking {} stars per frame, {} antialiasing", _paint_count,
+				 _p->antialias() == Antialias::Geometry ? "geometry" : "multisample");
 	}
 
 	virtual void update(Duration) override
 	{ }
 
-	virtual void frame_start() override
-	{ }
+	// The scene is flushed here, into the scaled target when dynamic resolution is on
+	virtual void frame() override
+	{
+		_p->begin_frame(engine().framebuffer_size(), engine().render_scale());
+		if(_bench_count > 0)
+			bench_frame();
+		else if(_paint_count > 0)
+			paint_bench_frame();
+		else
+		{
+			_p->begin_path();
+			_p->fill_color({1, 0, 0, 1});
+			_p->circle({100, 100}, 75.f);
+			_p->fill();
+		}
+		scene_end();
+
+		// Script frame() callbacks and frame_end draw at native resolution, after the upscale
+		_p->begin_frame(engine().framebuffer_size(), 1.f);
+	}
 
 	virtual void frame_end() override
 	{
-		_p->begin_frame(engine().framebuffer_size(), 1.f);
-		_p->begin_path();
-		_p->fill_color({1, 0, 0, 1});
-		_p->circle({100, 100}, 75.f);
-		_p->fill();
 		_p->end_frame();
+		if(_paint_count > 0 && _bench_frames >= 120)
+			paint_bench_report();
 	}
 
 	virtual void keyboard_event(Key key, bool pressed) override
@@ -53,6 +136,81 @@ public:
 	{
 		Application::resize_event(width, height);
 	}
+
+private:
+	void scene_end()
+	{
+		TimePoint start = Clock::now();
+		_p->end_frame();
+		_flush_time += Clock::now() - start;
+		_geometry = _p->frame_stats();
+	}
+
+	void bench_frame()
+	{
+		TimePoint start = Clock::now();
+		_p->fill_color({1, 0, 0, 1});
+		for(int i = 1; i <= _bench_count; ++i)
+		{
+			_p->begin_path();
+			_p->circle({(float) (i % 1900 + 10), (float) (i % 1060 + 10)}, 8.f);
+			_p->fill();
+		}
+		TimePoint middle = Clock::now();
+		sol::protected_function draw = engine().script().lua()["bench_circles"];
+		draw(_bench_count);
+		TimePoint end = Clock::now();
+
+		_native_time += middle - start;
+		_script_time += end - middle;
+		if(++_bench_frames < 120)
+			return;
+
+		WARN("ExampleApplication => {} circles, native {:.3f} ms/frame, script {:.3f} ms/frame",
+			 _bench_count, as_seconds(_native_time) * 1000.f / _bench_frames, as_seconds(_script_time) * 1000.f / _bench_frames);
+		_bench_frames = 0;
+		_native_time = _script_time = Duration{};
+	}
+
+	void paint_bench_frame()
+	{
+		TimePoint start = Clock::now();
+		_p->stroke_color({1, 1, 1, 1});
+		_p->stroke_width(2.f);
+		for(int i = 0; i < _paint_count; ++i)
+		{
+			glm::vec2 center{(float) (i * 37 % 1860 + 30), (float) (i * 53 % 1020 + 30)};
+			float spin = (float) i + (float) _bench_frames * 0.01f;
+			_p->begin_path();
+			for(int point = 0; point < 10; ++point)
+			{
+				float angle = spin + (float) point * 0.6283185f;
+				float radius = point % 2 == 0 ? 24.f : 10.f;
+				glm::vec2 at = center + glm::vec2(cos(angle), sin(angle)) * radius;
+				if(point == 0)
+					_p->move_to(at);
+				else
+					_p->line_to(at);
+			}
+			_p->close_path();
+			_p->fill_color({(float) (i % 7) / 7.f, 0.5f, 1.f - (float) (i % 5) / 5.f, 0.8f});
+			_p->fill();
+			_p->stroke();
+		}
+		_build_time += Clock::now() - start;
+		++_bench_frames;
+	}
+
+	void paint_bench_report()
+	{
+		FramePacer::Stats const& frames = engine().pacer().stats();
+		WARN("ExampleApplication => {} stars, {} : {} vertices, {} triangles, {} draw calls, build {:.3f} ms, flush {:.3f} ms, "
+			 "frame {:.3f} ms ({:.1f} fps)", _paint_count, _p->antialias() == Antialias::Geometry ? "geometry" : "multisample",
+			 _geometry.vertices, _geometry.triangles, _geometry.draw_calls, as_seconds(_build_time) * 1000.f / _bench_frames,
+			 as_seconds(_flush_time) * 1000.f / _bench_frames, as_seconds(frames.average) * 1000.f, frames.fps);
+		_bench_frames = 0;
+		_build_time = _flush_time = Duration{};
+	}
 };
 
 int main(int argc, char* argv[])
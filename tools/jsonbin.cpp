@@ -0,0 +1,155 @@
+#include <engine/utils/FileSystem.hpp>
+#include <engine/utils/Json.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <chrono>
+
+using namespace std;
+using nlohmann::json;
+
+namespace
+{
+	typedef chrono::high_resolution_clock Clock;
+
+	enum class Format
+	{
+		Cbor,
+		MsgPack
+	};
+
+	int usage()
+	{
+		cerr << "Usage: jsonbin <input.json> <output> [--cbor | --msgpack]\n"
+				"       jsonbin --dump <input> [--cbor | --msgpack]\n"
+				"       jsonbin --bench <input.json>...\n";
+		return 1;
+	}
+
+	json load(string const& file)
+	{
+		filesystem::MappedFile map{filesystem::Path(file)};
+		return json::parse(reinterpret_cast<char const*>(map.data()), map.size());
+	}
+
+	vector<uint8_t> encode(json const& j, Format format)
+	{
+		return format == Format::Cbor ? json::to_cbor(j) : json::to_msgpack(j);
+	}
+
+	json decode(uint8_t const* data, size_t size, Format format)
+	{
+		return format == Format::Cbor ? json::from_cbor(data, size) : json::from_msgpack(data, size);
+	}
+
+	int convert(string const& input, string const& output, Format format)
+	{
+		auto data = encode(load(input), format);
+
+		// Written aside and renamed so a failed build never leaves a truncated asset behind
+		string tmp = output + ".tmp";
+		{
+			ofstream out{tmp, ios::binary | ios::trunc};
+			out.write(reinterpret_cast<char const*>(data.data()), (streamsize) data.size());
+			if(!out) throw runtime_error("Could not write '" + tmp + "'");
+		}
+		if(rename(tmp.c_str(), output.c_str()) != 0)
+		{
+			remove(tmp.c_str());
+			throw runtime_error("Could not replace '" + output + "'");
+		}
+
+		cout << output << " : " << data.size() << " bytes (" << filesystem::Path(input).file_size() << " as text)" << endl;
+		return 0;
+	}
+
+	int dump(string const& input, Format format)
+	{
+		filesystem::MappedFile map{filesystem::Path(input)};
+		cout << decode(map.data(), map.size(), format).dump(4) << endl;
+		return 0;
+	}
+
+	// Decodes every document as text (into the heap and into an arena), CBOR and MessagePack, from memory so
+	// only parsing and destruction are measured
+	int bench(vector<string> const& inputs)
+	{
+		const int rounds = 20;
+		size_t text_size = 0, cbor_size = 0, msgpack_size = 0, checksum = 0;
+		Clock::duration text_time{}, arena_time{}, cbor_time{}, msgpack_time{};
+
+		for(auto const& input : inputs)
+		{
+			filesystem::MappedFile map{filesystem::Path(input)};
+			auto text = reinterpret_cast<char const*>(map.data());
+			json j = json::parse(text, map.size());
+			auto cbor = json::to_cbor(j);
+			auto msgpack = json::to_msgpack(j);
+			text_size += map.size();
+			cbor_size += cbor.size();
+			msgpack_size += msgpack.size();
+
+			auto start = Clock::now();
+			for(int i = 0; i < rounds; ++i)
+				checksum += json::parse(text, map.size()).size();
+			text_time += Clock::now() - start;
+
+			start = Clock::now();
+			for(int i = 0; i < rounds; ++i)
+			{
+				nlohmann::json_arena arena;
+				nlohmann::json_arena::scope scope{arena};
+				checksum += nlohmann::arena_json::parse(text, map.size()).size();
+			}
+			arena_time += Clock::now() - start;
+
+			start = Clock::now();
+			for(int i = 0; i < rounds; ++i)
+				checksum += json::from_cbor(cbor).size();
+			cbor_time += Clock::now() - start;
+
+			start = Clock::now();
+			for(int i = 0; i < rounds; ++i)
+				checksum += json::from_msgpack(msgpack).size();
+			msgpack_time += Clock::now() - start;
+		}
+
+		auto ms = [](Clock::duration d) { return chrono::duration<double, milli>(d).count() / rounds; };
+		cout << inputs.size() << " documents\n"
+			 << "text    " << text_size << " bytes, " << ms(text_time) << " ms\n"
+			 << "arena   " << text_size << " bytes, " << ms(arena_time) << " ms\n"
+			 << "cbor    " << cbor_size << " bytes, " << ms(cbor_time) << " ms\n"
+			 << "msgpack " << msgpack_size << " bytes, " << ms(msgpack_time) << " ms (" << checksum << ")" << endl;
+		return 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		if(argc >= 3 && strcmp(argv[1], "--bench") == 0)
+			return bench(vector<string>(argv + 2, argv + argc));
+		if(argc < 3)
+			return usage();
+
+		Format format = Format::Cbor;
+		bool to_text = strcmp(argv[1], "--dump") == 0;
+		for(int i = 3; i < argc; ++i)
+		{
+			if(strcmp(argv[i], "--cbor") == 0)
+				format = Format::Cbor;
+			else if(strcmp(argv[i], "--msgpack") == 0)
+				format = Format::MsgPack;
+			else
+				return usage();
+		}
+		return to_text ? dump(argv[2], format) : convert(argv[1], argv[2], format);
+	}
+	catch(exception const& e)
+	{
+		cerr << "jsonbin: " << e.what() << endl;
+		return 1;
+	}
+}
@@ -0,0 +1,145 @@
+#include <engine/utils/Archive.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <chrono>
+#include <dirent.h>
+
+using namespace std;
+
+namespace
+{
+	typedef chrono::high_resolution_clock Clock;
+
+	void collect(filesystem::Path const& root, string const& prefix, vector<string>& files)
+	{
+		filesystem::Path dir = prefix.empty() ? root : root / filesystem::Path(prefix);
+		DIR* d = opendir(dir.str().c_str());
+		if(d == nullptr) throw runtime_error("Could not open directory '" + dir.str() + "'");
+
+		while(dirent* ent = readdir(d))
+		{
+			if(ent->d_name[0] == '.')
+				continue;
+			string name = prefix.empty() ? string{ent->d_name} : prefix + "/" + ent->d_name;
+			filesystem::Path path = root / filesystem::Path(name);
+			if(path.is_directory())
+				collect(root, name, files);
+			else if(path.is_file())
+				files.push_back(name);
+		}
+		closedir(d);
+	}
+
+	int usage()
+	{
+		cerr << "Usage: pack <archive> <directory> [--lz4] [--align <bytes>]\n"
+				"       pack --list <archive>\n"
+				"       pack --bench <archive> <directory>\n";
+		return 1;
+	}
+
+	int pack(string const& archive, string const& dir, bool lz4, uint32_t alignment)
+	{
+		vector<string> files;
+		collect(filesystem::Path(dir), "", files);
+		sort(files.begin(), files.end());
+
+		ArchiveWriter writer{filesystem::Path(archive), alignment};
+		for(auto const& f : files)
+			writer.add_file(f, filesystem::Path(dir) / filesystem::Path(f), lz4);
+		writer.finish();
+
+		Archive check{filesystem::Path(archive)};
+		size_t compressed = 0;
+		for(auto const& f : files)
+			compressed += check.compressed(f) ? 1 : 0;
+		cout << archive << " : " << files.size() << " entries, " << compressed << " compressed, "
+			 << filesystem::Path(archive).file_size() << " bytes" << endl;
+		return 0;
+	}
+
+	int list(string const& file)
+	{
+		Archive archive{filesystem::Path(file)};
+		for(auto const& name : archive.names())
+			cout << name << "\t" << archive.size(name) << (archive.compressed(name) ? "\tlz4" : "") << "\n";
+		return 0;
+	}
+
+	// Loads every entry the loose way (stat, open, read) and then from the archive, best run with cold caches
+	int bench(string const& file, string const& dir)
+	{
+		unsigned checksum = 0;
+
+		auto start = Clock::now();
+		Archive archive{filesystem::Path(file)};
+		auto names = archive.names();
+		for(auto const& name : names)
+		{
+			auto view = archive.view(name);
+			if(view.data != nullptr)
+			{
+				for(size_t i = 0; i < view.size; i += 4096)
+					checksum += view.data[i];
+			}
+			else
+			{
+				auto data = archive.read(name);
+				checksum += data.empty() ? 0 : data[0];
+			}
+		}
+		auto packed = Clock::now() - start;
+
+		start = Clock::now();
+		vector<char> buffer;
+		for(auto const& name : names)
+		{
+			filesystem::Path path = filesystem::Path(dir) / filesystem::Path(name);
+			if(!path.exists())
+				continue;
+			buffer.resize(path.file_size());
+			ifstream in{path.str(), ios::binary};
+			in.read(buffer.data(), (streamsize) buffer.size());
+			checksum += buffer.empty() ? 0 : (unsigned char) buffer[0];
+		}
+		auto loose = Clock::now() - start;
+
+		auto ms = [](Clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+		cout << names.size() << " entries, loose " << ms(loose) << " ms, packed " << ms(packed) << " ms (" << checksum << ")" << endl;
+		return 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		if(argc == 3 && strcmp(argv[1], "--list") == 0)
+			return list(argv[2]);
+		if(argc == 4 && strcmp(argv[1], "--bench") == 0)
+			return bench(argv[2], argv[3]);
+		if(argc < 3)
+			return usage();
+
+		bool lz4 = false;
+		uint32_t alignment = 16;
+		for(int i = 3; i < argc; ++i)
+		{
+			if(strcmp(argv[i], "--lz4") == 0)
+				lz4 = true;
+			else if(strcmp(argv[i], "--align") == 0 && i + 1 < argc)
+				alignment = (uint32_t) stoul(argv[++i]);
+			else
+				return usage();
+		}
+		return pack(argv[1], argv[2], lz4, alignment);
+	}
+	catch(exception const& e)
+	{
+		cerr << "pack: " << e.what() << endl;
+		return 1;
+	}
+}